@@ -1,5 +1,6 @@
 #include "Crypto.h"
 #include "GrayscaleImage.h"
+#include "TaskScheduler.h"
 
 
 // Extract the least significant bits (LSBs) from SecretImage, calculating x, y based on message length
@@ -24,17 +25,18 @@ std::vector<int> Crypto::extract_LSBits(SecretImage& secret_image, int message_l
     int totalPixels = width * height;
     int startPixel = totalPixels - totalBits;
 
-    int lsb_index = 0;  
-    for (int i = startPixel; i < totalPixels; ++i) {
-        int r = i / width;
-        int c = i % width;
+    // Every bit has a fixed slot, so chunks of the range can be read in parallel.
+    LSB_array.resize(totalBits);
+    TaskScheduler::instance().parallel_for(startPixel, totalPixels, [&](int chunkBegin, int chunkEnd) {
+        for (int i = chunkBegin; i < chunkEnd; ++i) {
+            int r = i / width;
+            int c = i % width;
 
-        int pixelValue = image.get_pixel(r, c);
+            int pixelValue = image.get_pixel(r, c);
 
-        LSB_array.push_back(pixelValue & 1); 
-        
-        lsb_index++;
-    }
+            LSB_array[i - startPixel] = pixelValue & 1;
+        }
+    }, TaskScheduler::kMinElementsPerTask);
 
     return LSB_array;
 }
@@ -89,26 +91,25 @@ SecretImage Crypto::embed_LSBits(GrayscaleImage& image, const std::vector<int>&
     // Calculate the starting pixel index, so the last LSB ends up in the last pixel of the image.
     int startPixel = totalPixels - LSB_array.size();
 
-    // Embed the LSB array into the image
-    int lsbIndex = 0;  // Index for iterating through LSB_array
-    for (int i = startPixel; i < totalPixels; ++i) {
-        int r = i / image.get_width();
-        int c = i % image.get_width();
-
-        // Get the current pixel value
-        int pixelValue = image.get_pixel(r, c);
+    // Embed the LSB array into the image, each pixel only depends on its own bit
+    TaskScheduler::instance().parallel_for(startPixel, totalPixels, [&](int chunkBegin, int chunkEnd) {
+        for (int i = chunkBegin; i < chunkEnd; ++i) {
+            int r = i / image.get_width();
+            int c = i % image.get_width();
 
-        // Clear the LSB (make it 0)
-        pixelValue = pixelValue & ~1;
+            // Get the current pixel value
+            int pixelValue = image.get_pixel(r, c);
 
-        // Set the new LSB from the array
-        pixelValue = pixelValue | LSB_array[lsbIndex];
+            // Clear the LSB (make it 0)
+            pixelValue = pixelValue & ~1;
 
-        // Update the pixel in the image
-        image.set_pixel(r, c, pixelValue);
+            // Set the new LSB from the array
+            pixelValue = pixelValue | LSB_array[i - startPixel];
 
-        lsbIndex++;
-    }
+            // Update the pixel in the image
+            image.set_pixel(r, c, pixelValue);
+        }
+    }, TaskScheduler::kMinElementsPerTask);
 
     // Return a SecretImage object constructed from the modified GrayscaleImage
     SecretImage secretImage(image);
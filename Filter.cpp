@@ -1,6 +1,9 @@
 #include "Filter.h"
+#include "TaskScheduler.h"
+#include "GaussianPyramid.h"
 #include <algorithm>
 #include <cmath>
+#include <memory>
 #include <vector>
 #include <numeric>
 #include <math.h>
@@ -9,6 +12,23 @@
 #define M_PI 3.14159265358979323846
 #endif
 
+namespace {
+
+// Counts one level of nesting for the lifetime of the guard, also when the guarded code throws
+class DepthGuard {
+private:
+    int& depth;
+
+public:
+    explicit DepthGuard(int& depth) : depth(depth) { ++depth; }
+    ~DepthGuard() { --depth; }
+
+    DepthGuard(const DepthGuard&) = delete;
+    DepthGuard& operator=(const DepthGuard&) = delete;
+};
+
+} // namespace
+
 // Mean Filter
 void Filter::apply_mean_filter(GrayscaleImage& image, int kernelSize) {
     // TODO: Your code goes here.
@@ -30,31 +50,33 @@ void Filter::apply_mean_filter(GrayscaleImage& image, int kernelSize) {
     }
 
     // Her piksel için işlemi gerçekleştir.
-    for (int i = 0; i < height; ++i) {
-        for (int j = 0; j < width; ++j) {
-            int sum = 0;
-            int count = 0;
-
-            // Kernel üzerindeki piksellerin ortalamasını hesapla.
-            for (int ki = -halfKernel; ki <= halfKernel; ++ki) {
-                for (int kj = -halfKernel; kj <= halfKernel; ++kj) {
-                    int ni = i + ki;
-                    int nj = j + kj;
-
-                     // Kenarın dışına taşan durumları kontrol et ve dışa taşma durumunda 0 (siyah) ekle.
-                    if (ni >= 0 && ni < height && nj >= 0 && nj < width) {
-                        sum += originalImage.get_pixel(ni, nj);
-                    } else {
-                        sum += 0;  // Kernel taşarsa, siyah (0) pixel eklenir.
+    TaskScheduler::instance().parallel_for(0, height, [&](int rowBegin, int rowEnd) {
+        for (int i = rowBegin; i < rowEnd; ++i) {
+            for (int j = 0; j < width; ++j) {
+                int sum = 0;
+                int count = 0;
+
+                // Kernel üzerindeki piksellerin ortalamasını hesapla.
+                for (int ki = -halfKernel; ki <= halfKernel; ++ki) {
+                    for (int kj = -halfKernel; kj <= halfKernel; ++kj) {
+                        int ni = i + ki;
+                        int nj = j + kj;
+
+                         // Kenarın dışına taşan durumları kontrol et ve dışa taşma durumunda 0 (siyah) ekle.
+                        if (ni >= 0 && ni < height && nj >= 0 && nj < width) {
+                            sum += originalImage.get_pixel(ni, nj);
+                        } else {
+                            sum += 0;  // Kernel taşarsa, siyah (0) pixel eklenir.
+                        }
+                        ++count;
                     }
-                    ++count;
                 }
-            }
 
-            newData[i][j] = sum / count;
+                newData[i][j] = sum / count;
 
+            }
         }
-    }
+    });
 
     // Yeni pikselleri orijinal görüntüye ata.
     for (int i = 0; i < height; ++i) {
@@ -78,6 +100,27 @@ void Filter::apply_gaussian_smoothing(GrayscaleImage& image, int kernelSize, dou
     // 3. For each pixel, compute the weighted sum using the kernel.
     // 4. Update the pixel values with the smoothed results.
 
+    // Large sigma: blur through a Gaussian pyramid so the cost does not grow with the kernel.
+    // The level buffers are kept per thread and reused by the next image of the same size. A thread that
+    // helps the scheduler while waiting can re-enter here, so there is one pyramid per nesting depth.
+    int pyramidLevels = GaussianPyramid::levels_for_sigma(image.get_width(), image.get_height(), kernelSize, sigma);
+    if (pyramidLevels == 0) {
+        apply_gaussian_smoothing_direct(image, kernelSize, sigma);
+        return;
+    }
+
+    static thread_local std::vector<std::unique_ptr<GaussianPyramid>> pyramids;
+    static thread_local int depth = 0;
+    if (depth == static_cast<int>(pyramids.size())) {
+        pyramids.emplace_back(new GaussianPyramid());
+    }
+    GaussianPyramid& pyramid = *pyramids[depth];
+    DepthGuard guard(depth);
+    pyramid.smooth(image, kernelSize, sigma, pyramidLevels);
+}
+
+// Gaussian Smoothing Filter, direct convolution
+void Filter::apply_gaussian_smoothing_direct(GrayscaleImage& image, int kernelSize, double sigma) {
     int width = image.get_width();
     int height = image.get_height();
     int halfKernel = kernelSize / 2;
@@ -108,25 +151,27 @@ void Filter::apply_gaussian_smoothing(GrayscaleImage& image, int kernelSize, dou
     std::vector<std::vector<int>> newData(height, std::vector<int>(width, 0));  // Yeni görüntü için vektör
 
 
-        // Her piksel için Gaussian smoothing işlemi
-    for (int i = 0; i < height; ++i) {
-        for (int j = 0; j < width; ++j) {
-            double weightedSum = 0.0;
+    // Her piksel için Gaussian smoothing işlemi
+    TaskScheduler::instance().parallel_for(0, height, [&](int rowBegin, int rowEnd) {
+        for (int i = rowBegin; i < rowEnd; ++i) {
+            for (int j = 0; j < width; ++j) {
+                double weightedSum = 0.0;
 
-            for (int ki = -halfKernel; ki <= halfKernel; ++ki) {
-                for (int kj = -halfKernel; kj <= halfKernel; ++kj) {
-                    int ni = i + ki;
-                    int nj = j + kj;
+                for (int ki = -halfKernel; ki <= halfKernel; ++ki) {
+                    for (int kj = -halfKernel; kj <= halfKernel; ++kj) {
+                        int ni = i + ki;
+                        int nj = j + kj;
 
-                    if (ni >= 0 && ni < height && nj >= 0 && nj < width) {
-                        weightedSum += originalImage.get_pixel(ni, nj) * kernel[ki + halfKernel][kj + halfKernel];
+                        if (ni >= 0 && ni < height && nj >= 0 && nj < width) {
+                            weightedSum += originalImage.get_pixel(ni, nj) * kernel[ki + halfKernel][kj + halfKernel];
+                        }
                     }
                 }
-            }
 
-            newData[i][j] = static_cast<int>(std::floor(weightedSum));
+                newData[i][j] = static_cast<int>(std::floor(weightedSum));
+            }
         }
-    }
+    });
 
     // Yeni pikselleri ata
     for (int i = 0; i < height; ++i) {
@@ -146,21 +191,356 @@ void Filter::apply_unsharp_mask(GrayscaleImage& image, int kernelSize, double am
     apply_gaussian_smoothing(blurredImage, kernelSize, 1.0);
 
     // Step 2: Unsharp masking formula
-    for (int i = 0; i < height; ++i) {
-        for (int j = 0; j < width; ++j) {
-            int originalPixel = image.get_pixel(i, j);
-            int blurredPixel = blurredImage.get_pixel(i, j);
-            int sharpenedPixel = originalPixel + (amount * (originalPixel - blurredPixel));
+    TaskScheduler::instance().parallel_for(0, height, [&](int rowBegin, int rowEnd) {
+        for (int i = rowBegin; i < rowEnd; ++i) {
+            for (int j = 0; j < width; ++j) {
+                int originalPixel = image.get_pixel(i, j);
+                int blurredPixel = blurredImage.get_pixel(i, j);
+                int sharpenedPixel = originalPixel + (amount * (originalPixel - blurredPixel));
+
+                // Clamp values using std::clamp to ensure they are within the valid range [0-255]
+                if (sharpenedPixel > 255) {
+                    sharpenedPixel = 255;
+                } else if (sharpenedPixel < 0) {
+                    sharpenedPixel = 0;
+                }
 
-            // Clamp values using std::clamp to ensure they are within the valid range [0-255]
-            if (sharpenedPixel > 255) {
-                sharpenedPixel = 255;
-            } else if (sharpenedPixel < 0) {
-                sharpenedPixel = 0;
+                image.set_pixel(i, j, sharpenedPixel);
             }
+        }
+    });
+}
+
+// Builds the normalized Gaussian kernel as Q16 integer weights (row-major, kernelSize x kernelSize).
+// Each weight is floored and the leftover units go to the weights with the largest fractional parts,
+// so the weights sum to exactly 1 << 16 and every weight is within 2^-16 of its double value.
+static std::vector<int> make_fixed_gaussian_kernel(int kernelSize, double sigma) {
+    int halfKernel = kernelSize / 2;
+    int count = kernelSize * kernelSize;
 
-            image.set_pixel(i, j, sharpenedPixel);
+    // Same kernel as apply_gaussian_smoothing
+    std::vector<double> kernel(count);
+    double sum = 0.0;
+    for (int i = -halfKernel; i <= halfKernel; ++i) {
+        for (int j = -halfKernel; j <= halfKernel; ++j) {
+            double value = (1.0 / (2.0 * M_PI * sigma * sigma)) * exp(-(i * i + j * j) / (2.0 * sigma * sigma));
+            kernel[(i + halfKernel) * kernelSize + (j + halfKernel)] = value;
+            sum += value;
         }
     }
+
+    // Quantize with the largest remainder method
+    std::vector<int> weights(count);
+    std::vector<double> remainders(count);
+    int total = 0;
+    for (int k = 0; k < count; ++k) {
+        double scaled = kernel[k] / sum * 65536.0;
+        weights[k] = static_cast<int>(std::floor(scaled));
+        remainders[k] = scaled - weights[k];
+        total += weights[k];
+    }
+
+    std::vector<int> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](int a, int b) { return remainders[a] > remainders[b]; });
+    for (int k = 0; k < 65536 - total; ++k) {
+        weights[order[k]]++;
+    }
+
+    return weights;
+}
+
+// Gaussian Smoothing Filter, fixed-point path
+void Filter::apply_gaussian_smoothing_fixed(GrayscaleImage& image, int kernelSize, double sigma) {
+    // Error bound: with p in [0, 255], weights summing exactly to 1 and each weight error below 2^-16,
+    // the positive and negative weight errors cancel in total, so the weighted sum is off by less than
+    // 255 * kernelSize^2 / 2^17 before flooring.
+
+    int width = image.get_width();
+    int height = image.get_height();
+    int halfKernel = kernelSize / 2;
+
+    std::vector<int> weights = make_fixed_gaussian_kernel(kernelSize, sigma);
+
+    // Copy the original image for reference
+    GrayscaleImage originalImage = image;
+    int** source = originalImage.get_data();
+    int** target = image.get_data();
+
+    TaskScheduler::instance().parallel_for(0, height, [&](int rowBegin, int rowEnd) {
+        for (int i = rowBegin; i < rowEnd; ++i) {
+            // Restrict the kernel rows to the image instead of testing every tap
+            int kiStart = std::max(-halfKernel, -i);
+            int kiEnd = std::min(halfKernel, height - 1 - i);
+
+            for (int j = 0; j < width; ++j) {
+                int kjStart = std::max(-halfKernel, -j);
+                int kjEnd = std::min(halfKernel, width - 1 - j);
+
+                // At most 255 * 2^16, fits in an int
+                int weightedSum = 0;
+                for (int ki = kiStart; ki <= kiEnd; ++ki) {
+                    const int* row = source[i + ki];
+                    const int* weightRow = &weights[(ki + halfKernel) * kernelSize + halfKernel];
+                    for (int kj = kjStart; kj <= kjEnd; ++kj) {
+                        weightedSum += row[j + kj] * weightRow[kj];
+                    }
+                }
+
+                // Shifting floors, matching std::floor in the double path
+                target[i][j] = weightedSum >> 16;
+            }
+        }
+    });
 }
 
+// Unsharp Masking Filter, fixed-point path
+void Filter::apply_unsharp_mask_fixed(GrayscaleImage& image, int kernelSize, double amount) {
+    int width = image.get_width();
+    int height = image.get_height();
+
+    // Step 1: Blur with the fixed-point Gaussian
+    GrayscaleImage blurredImage = image;
+    apply_gaussian_smoothing_fixed(blurredImage, kernelSize, 1.0);
+
+    // Step 2: amount in Q8.8, off by at most 1/512
+    int fixedAmount = static_cast<int>(std::lround(amount * 256.0));
+    int** original = image.get_data();
+    int** blurred = blurredImage.get_data();
+
+    TaskScheduler::instance().parallel_for(0, height, [&](int rowBegin, int rowEnd) {
+        for (int i = rowBegin; i < rowEnd; ++i) {
+            for (int j = 0; j < width; ++j) {
+                int originalPixel = original[i][j];
+                int blurredPixel = blurred[i][j];
+
+                // Integer division truncates toward zero like the double -> int conversion in apply_unsharp_mask
+                int sharpenedPixel = (originalPixel * 256 + fixedAmount * (originalPixel - blurredPixel)) / 256;
+
+                original[i][j] = std::clamp(sharpenedPixel, 0, 255);
+            }
+        }
+    });
+}
+
+// Median Filter
+void Filter::apply_median_filter(GrayscaleImage& image, int kernelSize) {
+    // Perreault/Hebert: each column keeps a 256-bin histogram and a 16-bin coarse one of the kernelSize
+    // pixels above and below the current row; moving one row down updates each column with one pixel in
+    // and one out. Along a row only the coarse kernel histogram slides (16 bins in, 16 out). The fine bins
+    // of a coarse bucket are brought up to date lazily, when the median falls into that bucket, so a pixel
+    // costs a few dozen counter updates whatever kernelSize is.
+
+    int width = image.get_width();
+    int height = image.get_height();
+    int halfKernel = kernelSize / 2;
+
+    // Copy the original image for reference
+    GrayscaleImage originalImage = image;
+    int** source = originalImage.get_data();
+    int** target = image.get_data();
+
+    // Horizontal stripes are independent, each one builds its own column histograms
+    TaskScheduler::instance().parallel_for(0, height, [&](int rowBegin, int rowEnd) {
+        std::vector<unsigned int> columnFine(static_cast<size_t>(width) * 256, 0);
+        std::vector<unsigned int> columnCoarse(static_cast<size_t>(width) * 16, 0);
+        unsigned int kernelFine[256];
+        unsigned int kernelCoarse[16];
+        int fineColumn[16]; // window center the fine bins of each coarse bucket were last brought up to
+
+        auto add_pixel = [&](int row, int col, int delta) {
+            int value = std::clamp(source[row][col], 0, 255);
+            columnFine[col * 256 + value] += delta;
+            columnCoarse[col * 16 + (value >> 4)] += delta;
+        };
+        auto add_coarse = [&](int col, int sign) {
+            const unsigned int* coarse = &columnCoarse[col * 16];
+            for (int v = 0; v < 16; ++v) {
+                kernelCoarse[v] += sign * coarse[v];
+            }
+        };
+        auto add_fine = [&](int col, int bucket, int sign) {
+            const unsigned int* fine = &columnFine[col * 256 + bucket * 16];
+            unsigned int* kernel = &kernelFine[bucket * 16];
+            for (int v = 0; v < 16; ++v) {
+                kernel[v] += sign * fine[v];
+            }
+        };
+
+        // Bring the fine bins of one coarse bucket to the window centered on column j, by sliding them
+        // from where they were left or, when that is further than a kernel width, by summing them anew
+        auto update_fine = [&](int bucket, int j) {
+            int last = fineColumn[bucket];
+            if (2 * (j - last) > kernelSize) {
+                std::fill(kernelFine + bucket * 16, kernelFine + bucket * 16 + 16, 0u);
+                for (int col = std::max(0, j - halfKernel); col <= std::min(width - 1, j + halfKernel); ++col) {
+                    add_fine(col, bucket, 1);
+                }
+            } else {
+                for (int c = last + 1; c <= j; ++c) {
+                    if (c + halfKernel < width) {
+                        add_fine(c + halfKernel, bucket, 1);
+                    }
+                    if (c - halfKernel - 1 >= 0) {
+                        add_fine(c - halfKernel - 1, bucket, -1);
+                    }
+                }
+            }
+            fineColumn[bucket] = j;
+        };
+
+        // Column histograms for the window around the first row of the stripe
+        for (int r = std::max(0, rowBegin - halfKernel); r <= std::min(height - 1, rowBegin + halfKernel); ++r) {
+            for (int j = 0; j < width; ++j) {
+                add_pixel(r, j, 1);
+            }
+        }
+
+        for (int i = rowBegin; i < rowEnd; ++i) {
+            // Slide the column histograms down to row i
+            if (i > rowBegin) {
+                if (i - halfKernel - 1 >= 0) {
+                    for (int j = 0; j < width; ++j) {
+                        add_pixel(i - halfKernel - 1, j, -1);
+                    }
+                }
+                if (i + halfKernel < height) {
+                    for (int j = 0; j < width; ++j) {
+                        add_pixel(i + halfKernel, j, 1);
+                    }
+                }
+            }
+            int rowsInWindow = std::min(height - 1, i + halfKernel) - std::max(0, i - halfKernel) + 1;
+
+            // Coarse kernel histogram for the first pixel of the row; every bucket's fine bins are stale
+            std::fill(kernelCoarse, kernelCoarse + 16, 0u);
+            for (int j = 0; j <= std::min(width - 1, halfKernel); ++j) {
+                add_coarse(j, 1);
+            }
+            std::fill(fineColumn, fineColumn + 16, -kernelSize - 1);
+
+            for (int j = 0; j < width; ++j) {
+                int colsInWindow = std::min(width - 1, j + halfKernel) - std::max(0, j - halfKernel) + 1;
+                unsigned int rank = static_cast<unsigned int>(rowsInWindow * colsInWindow) / 2;
+
+                // Find the coarse bin holding the median, then the exact value inside it
+                int bin = 0;
+                while (rank >= kernelCoarse[bin]) {
+                    rank -= kernelCoarse[bin];
+                    ++bin;
+                }
+                update_fine(bin, j);
+                int value = bin * 16;
+                while (rank >= kernelFine[value]) {
+                    rank -= kernelFine[value];
+                    ++value;
+                }
+                target[i][j] = value;
+
+                // Slide the coarse kernel histogram one column to the right
+                if (j + halfKernel + 1 < width) {
+                    add_coarse(j + halfKernel + 1, 1);
+                }
+                if (j - halfKernel >= 0) {
+                    add_coarse(j - halfKernel, -1);
+                }
+            }
+        }
+    }, std::max(32, kernelSize));
+}
+
+// Min/max filter with the van Herk/Gil-Werman algorithm. The image is padded with `neutral`
+// (255 for min, 0 for max) so border windows only see pixels inside the image. The padded line is cut
+// into blocks of kernelSize; every window spans at most two blocks, so its result is
+// op(suffix of the first block, prefix of the second block).
+template <typename Op>
+static void apply_van_herk(GrayscaleImage& image, int kernelSize, int neutral, Op op) {
+    int width = image.get_width();
+    int height = image.get_height();
+    int halfKernel = kernelSize / 2;
+    kernelSize = 2 * halfKernel + 1;
+    int** data = image.get_data();
+
+    // Horizontal pass, in place row by row
+    TaskScheduler::instance().parallel_for(0, height, [&](int rowBegin, int rowEnd) {
+        int length = width + 2 * halfKernel;
+        std::vector<int> prefix(length);
+        std::vector<int> suffix(length);
+
+        for (int i = rowBegin; i < rowEnd; ++i) {
+            int* row = data[i];
+            auto padded = [&](int x) { return (x < halfKernel || x >= width + halfKernel) ? neutral : row[x - halfKernel]; };
+
+            for (int x = 0; x < length; ++x) {
+                prefix[x] = (x % kernelSize == 0) ? padded(x) : op(prefix[x - 1], padded(x));
+            }
+            for (int x = length - 1; x >= 0; --x) {
+                suffix[x] = (x % kernelSize == kernelSize - 1 || x == length - 1) ? padded(x) : op(suffix[x + 1], padded(x));
+            }
+            for (int j = 0; j < width; ++j) {
+                row[j] = op(suffix[j], prefix[j + kernelSize - 1]);
+            }
+        }
+    });
+
+    // Vertical pass, whole rows at a time so the inner loops run along memory
+    int length = height + 2 * halfKernel;
+    std::vector<int> prefix(static_cast<size_t>(length) * width);
+    std::vector<int> suffix(static_cast<size_t>(length) * width);
+    std::vector<int> neutralRow(width, neutral);
+    auto padded = [&](int y) { return (y < halfKernel || y >= height + halfKernel) ? neutralRow.data() : data[y - halfKernel]; };
+
+    // Blocks are independent
+    int blockCount = (length + kernelSize - 1) / kernelSize;
+    TaskScheduler::instance().parallel_for(0, blockCount, [&](int blockBegin, int blockEnd) {
+        for (int block = blockBegin; block < blockEnd; ++block) {
+            int first = block * kernelSize;
+            int last = std::min(length, first + kernelSize) - 1;
+
+            for (int y = first; y <= last; ++y) {
+                const int* in = padded(y);
+                int* out = &prefix[static_cast<size_t>(y) * width];
+                if (y == first) {
+                    std::copy(in, in + width, out);
+                    continue;
+                }
+                const int* previous = out - width;
+                for (int j = 0; j < width; ++j) {
+                    out[j] = op(previous[j], in[j]);
+                }
+            }
+            for (int y = last; y >= first; --y) {
+                const int* in = padded(y);
+                int* out = &suffix[static_cast<size_t>(y) * width];
+                if (y == last) {
+                    std::copy(in, in + width, out);
+                    continue;
+                }
+                const int* next = out + width;
+                for (int j = 0; j < width; ++j) {
+                    out[j] = op(next[j], in[j]);
+                }
+            }
+        }
+    }, 1);
+
+    TaskScheduler::instance().parallel_for(0, height, [&](int rowBegin, int rowEnd) {
+        for (int i = rowBegin; i < rowEnd; ++i) {
+            const int* top = &suffix[static_cast<size_t>(i) * width];
+            const int* bottom = &prefix[static_cast<size_t>(i + kernelSize - 1) * width];
+            for (int j = 0; j < width; ++j) {
+                data[i][j] = op(top[j], bottom[j]);
+            }
+        }
+    });
+}
+
+// Min Filter (erosion)
+void Filter::apply_min_filter(GrayscaleImage& image, int kernelSize) {
+    apply_van_herk(image, kernelSize, 255, [](int a, int b) { return std::min(a, b); });
+}
+
+// Max Filter (dilation)
+void Filter::apply_max_filter(GrayscaleImage& image, int kernelSize) {
+    apply_van_herk(image, kernelSize, 0, [](int a, int b) { return std::max(a, b); });
+}
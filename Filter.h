@@ -8,11 +8,36 @@ public:
     // Apply the Mean Filter
     static void apply_mean_filter(GrayscaleImage& image, int kernelSize = 3);
 
-    // Apply Gaussian Smoothing Filter
+    // Apply Gaussian Smoothing Filter. Large sigma with a kernel covering at least +-3 sigma is computed
+    // through a GaussianPyramid at a cost independent of sigma. Its result stays within 2 gray levels of
+    // apply_gaussian_smoothing_direct, border included (measured, tests/test_gaussian_pyramid.cpp).
     static void apply_gaussian_smoothing(GrayscaleImage& image, int kernelSize = 3, double sigma = 1.0);
 
+    // Gaussian Smoothing as a direct kernelSize x kernelSize convolution, never routed through the pyramid
+    static void apply_gaussian_smoothing_direct(GrayscaleImage& image, int kernelSize = 3, double sigma = 1.0);
+
     // Apply Unsharp Masking Filter
     static void apply_unsharp_mask(GrayscaleImage& image, int kernelSize = 3, double amount = 1.5);
+
+    // Fixed-point variants with Q16 integer kernel weights (opt-in).
+    // For pixels in [0, 255] the Gaussian result differs from apply_gaussian_smoothing_direct by at most
+    // ceil(255 * kernelSize^2 / 2^17) gray levels, i.e. at most 1 level for kernelSize <= 21
+    // (checked by tests/test_fixed_point.cpp). The fixed-point path never routes through the pyramid.
+    static void apply_gaussian_smoothing_fixed(GrayscaleImage& image, int kernelSize = 3, double sigma = 1.0);
+
+    // The sharpened result differs from apply_unsharp_mask by at most ceil(|amount| * E + 0.5) gray levels,
+    // where E is the Gaussian bound above.
+    static void apply_unsharp_mask_fixed(GrayscaleImage& image, int kernelSize = 3, double amount = 1.5);
+
+    // Apply Median Filter. Perreault/Hebert constant-time median: sliding coarse histograms with lazily
+    // updated fine bins, so the cost per pixel does not grow with kernelSize.
+    // Pixels are expected in [0, 255]; near the border only the pixels inside the image are considered.
+    static void apply_median_filter(GrayscaleImage& image, int kernelSize = 3);
+
+    // Apply Min Filter (erosion) and Max Filter (dilation) with a square kernel. Uses the van Herk/Gil-Werman
+    // algorithm, about three comparisons per pixel and pass regardless of kernelSize.
+    static void apply_min_filter(GrayscaleImage& image, int kernelSize = 3);
+    static void apply_max_filter(GrayscaleImage& image, int kernelSize = 3);
 };
 
 #endif // FILTER_H
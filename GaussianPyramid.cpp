@@ -0,0 +1,255 @@
+#include "GaussianPyramid.h"
+#include "TaskScheduler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+// Binomial taps for offsets -2..2
+const int kTaps[5] = {1, 4, 6, 4, 1};
+
+// Smallest side a coarse level may have when used for smoothing
+const int kMinLevelSize = 16;
+
+// Coarse pixels the reduce and expand steps of all levels together spread a value by
+const int kBinomialReach = 4;
+
+// Each pyramid step (reduce and expand alike) adds variance 1, measured in pixels of the finer level
+double pyramid_variance(int levels) {
+    return 2.0 * (std::pow(4.0, levels) - 1.0) / 3.0;
+}
+
+} // namespace
+
+// Constructor: no levels allocated yet
+GaussianPyramid::GaussianPyramid() : base_width(0), base_height(0), margin(0) {}
+
+// Allocate the level buffers, keeping the current ones if the shape did not change
+void GaussianPyramid::reserve(int width, int height, int levelCount, int levelMargin) {
+    if (width == base_width && height == base_height && levelCount == get_level_count() && levelMargin == margin) {
+        return;
+    }
+
+    levels.clear();
+    int w = width;
+    int h = height;
+    for (int level = 1; level <= levelCount; ++level) {
+        w = (w + 1) / 2;
+        h = (h + 1) / 2;
+        int padding = levelMargin << (levelCount - level);
+        levels.emplace_back(new GrayscaleImage(w + 2 * padding, h + 2 * padding));
+    }
+
+    base_width = width;
+    base_height = height;
+    margin = levelMargin;
+}
+
+// Build levels 1..levelCount from the image
+void GaussianPyramid::build(const GrayscaleImage& image, int levelCount, int levelMargin) {
+    reserve(image.get_width(), image.get_height(), levelCount, levelMargin);
+
+    // The image itself has no padding, level 1 reaches get_padding(0) image pixels past its edges
+    if (levelCount >= 1) {
+        reduce(image, get_level(1), get_padding(0));
+    }
+    for (int level = 2; level <= levelCount; ++level) {
+        reduce(get_level(level - 1), get_level(level));
+    }
+}
+
+// Expand from a coarse level back to full resolution
+void GaussianPyramid::collapse(int fromLevel, GrayscaleImage& image) {
+    for (int level = fromLevel; level > 1; --level) {
+        expand(get_level(level), get_level(level - 1));
+    }
+    if (fromLevel >= 1) {
+        expand(get_level(1), image, get_padding(0));
+    }
+}
+
+// Fused 5x5 binomial blur and 2x decimation
+void GaussianPyramid::reduce(const GrayscaleImage& source, GrayscaleImage& target, int sourceOffset) {
+    int sourceWidth = source.get_width();
+    int sourceHeight = source.get_height();
+    int targetWidth = target.get_width();
+    int targetHeight = target.get_height();
+    int** in = source.get_data();
+    int** out = target.get_data();
+
+    // Horizontal pass, only at the even columns that survive decimation (values scaled by 16)
+    scratch.resize(static_cast<size_t>(sourceHeight) * targetWidth);
+    TaskScheduler::instance().parallel_for(0, sourceHeight, [&](int rowBegin, int rowEnd) {
+        for (int y = rowBegin; y < rowEnd; ++y) {
+            const int* row = in[y];
+            int* line = &scratch[static_cast<size_t>(y) * targetWidth];
+            for (int j = 0; j < targetWidth; ++j) {
+                int x = 2 * j - sourceOffset;
+                int sum = 0;
+                for (int b = -2; b <= 2; ++b) {
+                    if (x + b >= 0 && x + b < sourceWidth) {
+                        sum += kTaps[b + 2] * row[x + b];
+                    }
+                }
+                line[j] = sum;
+            }
+        }
+    });
+
+    // Vertical pass at the even rows (values scaled by 256), rounded back to pixels
+    TaskScheduler::instance().parallel_for(0, targetHeight, [&](int rowBegin, int rowEnd) {
+        for (int i = rowBegin; i < rowEnd; ++i) {
+            int y = 2 * i - sourceOffset;
+            for (int j = 0; j < targetWidth; ++j) {
+                int sum = 0;
+                for (int a = -2; a <= 2; ++a) {
+                    if (y + a >= 0 && y + a < sourceHeight) {
+                        sum += kTaps[a + 2] * scratch[static_cast<size_t>(y + a) * targetWidth + j];
+                    }
+                }
+                out[i][j] = (sum + 128) >> 8;
+            }
+        }
+    });
+}
+
+// 2x upsampling: even positions take 1/8, 6/8, 1/8 of three coarse pixels, odd positions 4/8, 4/8 of two
+void GaussianPyramid::expand(const GrayscaleImage& source, GrayscaleImage& target, int targetOffset) {
+    int sourceWidth = source.get_width();
+    int sourceHeight = source.get_height();
+    int targetWidth = target.get_width();
+    int targetHeight = target.get_height();
+    int** in = source.get_data();
+    int** out = target.get_data();
+
+    // Coarse sample m of a line with `count` samples spaced by `stride`, 0 outside the line
+    auto sample = [](const int* line, int m, int count, int stride) {
+        return m >= 0 && m < count ? line[m * stride] : 0;
+    };
+
+    // Horizontal pass on every coarse row (values scaled by 8)
+    scratch.resize(static_cast<size_t>(sourceHeight) * targetWidth);
+    TaskScheduler::instance().parallel_for(0, sourceHeight, [&](int rowBegin, int rowEnd) {
+        for (int y = rowBegin; y < rowEnd; ++y) {
+            const int* row = in[y];
+            int* line = &scratch[static_cast<size_t>(y) * targetWidth];
+            for (int x = 0; x < targetWidth; ++x) {
+                int m = (x + targetOffset) / 2;
+                if ((x + targetOffset) % 2 == 0) {
+                    line[x] = sample(row, m - 1, sourceWidth, 1) + 6 * sample(row, m, sourceWidth, 1) +
+                              sample(row, m + 1, sourceWidth, 1);
+                } else {
+                    line[x] = 4 * sample(row, m, sourceWidth, 1) + 4 * sample(row, m + 1, sourceWidth, 1);
+                }
+            }
+        }
+    });
+
+    // Vertical pass (values scaled by 64), rounded and clamped back to pixels
+    TaskScheduler::instance().parallel_for(0, targetHeight, [&](int rowBegin, int rowEnd) {
+        for (int y = rowBegin; y < rowEnd; ++y) {
+            int m = (y + targetOffset) / 2;
+            for (int x = 0; x < targetWidth; ++x) {
+                const int* column = &scratch[x];
+                int sum = ((y + targetOffset) % 2 == 0)
+                    ? sample(column, m - 1, sourceHeight, targetWidth) + 6 * sample(column, m, sourceHeight, targetWidth) +
+                      sample(column, m + 1, sourceHeight, targetWidth)
+                    : 4 * sample(column, m, sourceHeight, targetWidth) + 4 * sample(column, m + 1, sourceHeight, targetWidth);
+                out[y][x] = std::clamp((sum + 32) >> 6, 0, 255);
+            }
+        }
+    });
+}
+
+// Pick the deepest level that still leaves a residual sigma of at least 1 coarse pixel
+int GaussianPyramid::levels_for_sigma(int width, int height, int kernelSize, double sigma) {
+    // A kernel narrower than +-3 sigma is a truncated blur the pyramid cannot reproduce: at +-2 sigma
+    // fine detail already comes out up to 10 gray levels away from the direct convolution
+    int halfKernel = kernelSize / 2;
+    if (halfKernel < 3.0 * sigma) {
+        return 0;
+    }
+
+    int levelCount = 0;
+    while (true) {
+        int next = levelCount + 1;
+        double residual = (sigma * sigma - pyramid_variance(next)) / std::pow(4.0, next);
+        if (residual < 1.0 || std::min(width, height) >> next < kMinLevelSize) {
+            break;
+        }
+        levelCount = next;
+    }
+    return levelCount;
+}
+
+// Blur through the pyramid
+void GaussianPyramid::smooth(GrayscaleImage& image, int kernelSize, double sigma, int levelCount) {
+    // The residual blur below relies on the kernel covering +-3 sigma and on enough residual sigma
+    if (levelCount < 1 || levelCount > levels_for_sigma(image.get_width(), image.get_height(), kernelSize, sigma)) {
+        throw std::invalid_argument("GaussianPyramid::smooth: kernel size, sigma and level count do not allow a pyramid blur.");
+    }
+
+    // Remaining blur at the coarsest level, in coarse pixels
+    double scale = std::pow(2.0, levelCount);
+    double residualSigma = std::sqrt(std::max(0.0, sigma * sigma - pyramid_variance(levelCount))) / scale;
+
+    // The requested kernel covers at least +-3 sigma (see levels_for_sigma), the tails beyond carry no weight
+    int residualHalfKernel = std::max(1, static_cast<int>(std::ceil(3.0 * residualSigma)));
+
+    // The residual kernel plus the reach of the binomial steps (under 4 coarse pixels in total) is how far
+    // the blurred image spreads into the zero border, so that is the padding every level needs
+    build(image, levelCount, residualHalfKernel + kBinomialReach);
+    blur_level(get_level(levelCount), residualHalfKernel, residualSigma);
+    collapse(levelCount, image);
+}
+
+// Residual blur of the coarsest level
+void GaussianPyramid::blur_level(GrayscaleImage& level, int halfKernel, double sigma) {
+    int width = level.get_width();
+    int height = level.get_height();
+    int** data = level.get_data();
+
+    // The 2D Gaussian of the direct path is the product of this 1D kernel with itself, normalized alike
+    blur_kernel.resize(2 * halfKernel + 1);
+    double sum = 0.0;
+    for (int k = -halfKernel; k <= halfKernel; ++k) {
+        blur_kernel[k + halfKernel] = std::exp(-(k * k) / (2.0 * sigma * sigma));
+        sum += blur_kernel[k + halfKernel];
+    }
+    for (double& weight : blur_kernel) {
+        weight /= sum;
+    }
+
+    // Horizontal pass into the scratch buffer
+    blur_scratch.resize(static_cast<size_t>(width) * height);
+    TaskScheduler::instance().parallel_for(0, height, [&](int rowBegin, int rowEnd) {
+        for (int y = rowBegin; y < rowEnd; ++y) {
+            const int* row = data[y];
+            double* line = &blur_scratch[static_cast<size_t>(y) * width];
+            for (int x = 0; x < width; ++x) {
+                double weighted = 0.0;
+                for (int k = std::max(-halfKernel, -x); k <= std::min(halfKernel, width - 1 - x); ++k) {
+                    weighted += blur_kernel[k + halfKernel] * row[x + k];
+                }
+                line[x] = weighted;
+            }
+        }
+    });
+
+    // Vertical pass back into the level, floored like the direct path
+    TaskScheduler::instance().parallel_for(0, height, [&](int rowBegin, int rowEnd) {
+        for (int y = rowBegin; y < rowEnd; ++y) {
+            int kStart = std::max(-halfKernel, -y);
+            int kEnd = std::min(halfKernel, height - 1 - y);
+            for (int x = 0; x < width; ++x) {
+                double weighted = 0.0;
+                for (int k = kStart; k <= kEnd; ++k) {
+                    weighted += blur_kernel[k + halfKernel] * blur_scratch[static_cast<size_t>(y + k) * width + x];
+                }
+                data[y][x] = std::clamp(static_cast<int>(std::floor(weighted)), 0, 255);
+            }
+        }
+    });
+}
@@ -0,0 +1,75 @@
+#ifndef GAUSSIAN_PYRAMID_H
+#define GAUSSIAN_PYRAMID_H
+
+#include <memory>
+#include <vector>
+
+#include "GrayscaleImage.h"
+
+// Gaussian pyramid over a GrayscaleImage. Level 0 is the image itself, level k is half the size of
+// level k - 1 (rounded up). Level buffers are allocated by reserve()/build() and reused as long as
+// the image size, level count and margin stay the same. The scratch buffers of the passes are kept too,
+// so smoothing a stream of same-sized frames allocates no pixel buffers after the first one; only the
+// small closures of the parallel loops and the scheduler's per-task state are still allocated.
+//
+// Pixels outside the image count as 0, as in Filter::apply_gaussian_smoothing. To make the coarse levels
+// see that zero border instead of cutting it off, every level can carry a margin around the image:
+// level k is padded by margin * 2^(levels - k) pixels on each side, so pixel i of level k sits exactly
+// above pixel 2i of level k - 1 and the padding of every level covers the same area of the image plane.
+class GaussianPyramid {
+public:
+    GaussianPyramid();
+
+    // Allocate buffers for levels 1..levels of a width x height image (no-op if already allocated).
+    // margin is the padding of the coarsest level, in its own pixels.
+    void reserve(int width, int height, int levels, int margin = 0);
+
+    // Fill levels 1..levels from the image, each one reduced from the previous
+    void build(const GrayscaleImage& image, int levels, int margin = 0);
+
+    // Expand level `fromLevel` back up level by level and write the full-resolution result into image.
+    // Overwrites the buffers of the levels in between.
+    void collapse(int fromLevel, GrayscaleImage& image);
+
+    // Number of levels above level 0 currently allocated
+    int get_level_count() const { return static_cast<int>(levels.size()); }
+
+    // Access level 1..get_level_count(), including its padding
+    GrayscaleImage& get_level(int level) { return *levels[level - 1]; }
+
+    // Padding of level 0..get_level_count() on each side, in pixels of that level
+    int get_padding(int level) const { return margin << (get_level_count() - level); }
+
+    // Blur with the fused 5-tap binomial kernel [1 4 6 4 1] / 16 in both directions and drop every
+    // other row and column: target pixel (i, j) is centered on source pixel (2i - offset, 2j - offset).
+    // Pixels outside the source count as 0.
+    void reduce(const GrayscaleImage& source, GrayscaleImage& target, int sourceOffset = 0);
+
+    // Double the size, interpolating with the same kernel (scaled by 2): target pixel (y, x) lies at
+    // (y + offset, x + offset) of the upsampled source. Pixels outside the source count as 0.
+    void expand(const GrayscaleImage& source, GrayscaleImage& target, int targetOffset = 0);
+
+    // Number of pyramid levels to use for a Gaussian blur of the given size, 0 if a direct
+    // convolution should be used (small sigma, truncated kernel or image too small)
+    static int levels_for_sigma(int width, int height, int kernelSize, double sigma);
+
+    // Gaussian blur through `levels` pyramid levels: reduce, blur the coarsest level with the
+    // remaining sigma, then expand back. The cost depends on the image size, not on sigma.
+    // The levels are padded by the reach of the blur, so the border follows the direct convolution too.
+    // Throws std::invalid_argument unless 1 <= levels <= levels_for_sigma(width, height, kernelSize, sigma).
+    void smooth(GrayscaleImage& image, int kernelSize, double sigma, int levels);
+
+private:
+    std::vector<std::unique_ptr<GrayscaleImage>> levels;
+    std::vector<int> scratch;         // intermediate result between the horizontal and vertical pass
+    std::vector<double> blur_scratch; // same for the residual blur
+    std::vector<double> blur_kernel;  // 1D weights of the residual blur
+    int base_width, base_height;
+    int margin;                       // padding of the coarsest level
+
+    // Separable Gaussian blur of a level in place with a 2 * halfKernel + 1 kernel, pixels outside count as 0.
+    // Same normalized kernel and flooring as Filter::apply_gaussian_smoothing_direct, in the member buffers.
+    void blur_level(GrayscaleImage& level, int halfKernel, double sigma);
+};
+
+#endif // GAUSSIAN_PYRAMID_H
@@ -6,6 +6,128 @@
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #include "stb_image_write.h"
 #include <stdexcept>
+#include <algorithm>
+#include <cstdlib>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define GRAYSCALE_AVX2_DISPATCH 1
+#include <immintrin.h>
+#endif
+
+// Row kernels shared by the arithmetic operators. Pixels are stored as int, so the AVX2
+// versions work on 8 pixels per instruction. They are compiled with a per-function target
+// attribute and picked at run time when the CPU supports AVX2, so no -mavx2 flag is needed;
+// the scalar versions handle the tail and every other CPU.
+namespace {
+
+using RowKernel = void (*)(int* dst, const int* a, const int* b, int n);
+using BlendKernel = void (*)(int* dst, const int* a, const int* b, int w, int n);
+
+// dst = min(a + b, 255)
+void add_saturate_row_scalar(int* dst, const int* a, const int* b, int n) {
+    for (int j = 0; j < n; ++j) {
+        dst[j] = std::min(a[j] + b[j], 255);
+    }
+}
+
+// dst = max(a - b, 0)
+void sub_saturate_row_scalar(int* dst, const int* a, const int* b, int n) {
+    for (int j = 0; j < n; ++j) {
+        dst[j] = std::max(a[j] - b[j], 0);
+    }
+}
+
+// dst = |a - b|
+void abs_diff_row_scalar(int* dst, const int* a, const int* b, int n) {
+    for (int j = 0; j < n; ++j) {
+        dst[j] = std::abs(a[j] - b[j]);
+    }
+}
+
+// dst = (a * (256 - w) + b * w + 128) >> 8, with w in [0, 256]
+void blend_row_scalar(int* dst, const int* a, const int* b, int w, int n) {
+    for (int j = 0; j < n; ++j) {
+        dst[j] = (a[j] * (256 - w) + b[j] * w + 128) >> 8;
+    }
+}
+
+#if defined(GRAYSCALE_AVX2_DISPATCH)
+
+__attribute__((target("avx2")))
+void add_saturate_row_avx2(int* dst, const int* a, const int* b, int n) {
+    const __m256i max_value = _mm256_set1_epi32(255);
+    int j = 0;
+    for (; j + 8 <= n; j += 8) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + j));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + j));
+        __m256i sum = _mm256_min_epi32(_mm256_add_epi32(va, vb), max_value);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + j), sum);
+    }
+    add_saturate_row_scalar(dst + j, a + j, b + j, n - j);
+}
+
+__attribute__((target("avx2")))
+void sub_saturate_row_avx2(int* dst, const int* a, const int* b, int n) {
+    const __m256i zero = _mm256_setzero_si256();
+    int j = 0;
+    for (; j + 8 <= n; j += 8) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + j));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + j));
+        __m256i difference = _mm256_max_epi32(_mm256_sub_epi32(va, vb), zero);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + j), difference);
+    }
+    sub_saturate_row_scalar(dst + j, a + j, b + j, n - j);
+}
+
+__attribute__((target("avx2")))
+void abs_diff_row_avx2(int* dst, const int* a, const int* b, int n) {
+    int j = 0;
+    for (; j + 8 <= n; j += 8) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + j));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + j));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + j), _mm256_abs_epi32(_mm256_sub_epi32(va, vb)));
+    }
+    abs_diff_row_scalar(dst + j, a + j, b + j, n - j);
+}
+
+__attribute__((target("avx2")))
+void blend_row_avx2(int* dst, const int* a, const int* b, int w, int n) {
+    const __m256i weight_a = _mm256_set1_epi32(256 - w);
+    const __m256i weight_b = _mm256_set1_epi32(w);
+    const __m256i rounding = _mm256_set1_epi32(128);
+    int j = 0;
+    for (; j + 8 <= n; j += 8) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + j));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + j));
+        __m256i mixed = _mm256_add_epi32(_mm256_mullo_epi32(va, weight_a), _mm256_mullo_epi32(vb, weight_b));
+        mixed = _mm256_srai_epi32(_mm256_add_epi32(mixed, rounding), 8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + j), mixed);
+    }
+    blend_row_scalar(dst + j, a + j, b + j, w, n - j);
+}
+
+#endif // GRAYSCALE_AVX2_DISPATCH
+
+// The kernels used by this process, chosen once from the CPU features
+struct RowKernels {
+    RowKernel add_saturate;
+    RowKernel sub_saturate;
+    RowKernel abs_diff;
+    BlendKernel blend;
+};
+
+const RowKernels& row_kernels() {
+    static const RowKernels kernels = []() {
+#if defined(GRAYSCALE_AVX2_DISPATCH)
+        if (__builtin_cpu_supports("avx2")) {
+            return RowKernels{add_saturate_row_avx2, sub_saturate_row_avx2, abs_diff_row_avx2, blend_row_avx2};
+        }
+#endif
+        return RowKernels{add_saturate_row_scalar, sub_saturate_row_scalar, abs_diff_row_scalar, blend_row_scalar};
+    }();
+    return kernels;
+}
+
+} // namespace
 
 
 // Constructor: load from a file
@@ -39,6 +161,35 @@ GrayscaleImage::GrayscaleImage(const char* filename) {
     
 }
 
+// Constructor: decode from an encoded buffer held in memory
+GrayscaleImage::GrayscaleImage(const unsigned char* buffer, int length) {
+
+    // Image decoding code using stbi
+    int channels;
+    unsigned char* image = stbi_load_from_memory(buffer, length, &width, &height, &channels, STBI_grey);
+
+    //unlike the file constructor, report the failure to the caller so batch jobs can skip the image
+    if (image == nullptr) {
+        throw std::runtime_error("Could not decode image from memory buffer.");
+    }
+
+    //dynamically allocate memory for a 2D matrix to store the image data
+    data = new int*[height];
+    for (int i = 0; i < height; ++i) {
+        data[i] = new int[width];
+    }
+
+    //copy pixel values from the decoded image to the data matrix
+    for (int i = 0; i < height; ++i) {
+        for (int j = 0; j < width; ++j) {
+            data[i][j] = image[i * width + j];
+        }
+    }
+
+    // Free the dynamically allocated memory of stbi image
+    stbi_image_free(image);
+}
+
 // Constructor: initialize from a pre-existing data matrix
 GrayscaleImage::GrayscaleImage(int** inputData, int h, int w) {
 
@@ -70,6 +221,16 @@ GrayscaleImage::GrayscaleImage(int w, int h) : width(w), height(h) {
     }
 }
 
+// Constructor: allocate rows that the caller fills completely
+GrayscaleImage::GrayscaleImage(int w, int h, Uninitialized) : width(w), height(h) {
+
+    //dynamically allocate memory for the data matrix, the pixels are left unset
+    data = new int*[height];
+    for (int i = 0; i < height; ++i) {
+        data[i] = new int[width];
+    }
+}
+
 // Copy constructor
 GrayscaleImage::GrayscaleImage(const GrayscaleImage& other) {
 
@@ -77,17 +238,11 @@ GrayscaleImage::GrayscaleImage(const GrayscaleImage& other) {
     width = other.width;
     height = other.height;
 
-   //dynamically allocate memory for the data matrix
+   //dynamically allocate memory for the data matrix and copy each row from the other image
     data = new int*[height];
     for (int i = 0; i < height; ++i) {
         data[i] = new int[width];
-    }
-
-    //copy pixel values from the other image to the new one
-    for (int i = 0; i < height; ++i) {
-        for (int j = 0; j < width; ++j) {
-            data[i][j] = other.data[i][j];
-        }
+        std::memcpy(data[i], other.data[i], sizeof(int) * width);
     }
 }
 
@@ -109,12 +264,10 @@ bool GrayscaleImage::operator==(const GrayscaleImage& other) const {
         return false;
     }
 
-    //check if all pixel values are the same
+    //compare row by row, stopping at the first row that differs
     for (int i = 0; i < height; ++i) {
-        for (int j = 0; j < width; ++j) {
-            if (data[i][j] != other.data[i][j]) {
-                return false;
-            }
+        if (std::memcmp(data[i], other.data[i], sizeof(int) * width) != 0) {
+            return false;
         }
     }
 
@@ -123,45 +276,85 @@ bool GrayscaleImage::operator==(const GrayscaleImage& other) const {
 
 // Addition operator
 GrayscaleImage GrayscaleImage::operator+(const GrayscaleImage& other) const {
-    // Create a new image for the result
-    GrayscaleImage result(width, height);
-    
-    //add pixel values of both images
+    check_same_size(other);
+
+    //write the clamped sums straight into the rows of the new image, one pass over the inputs
+    GrayscaleImage result(width, height, Uninitialized());
     for (int i = 0; i < height; ++i) {
-        for (int j = 0; j < width; ++j) {
-            int total = data[i][j] + other.data[i][j];
-            if (total > 255) { //pixel values have to be in [0,255] range
-                result.data[i][j] = 255;
-            } else {
-            result.data[i][j] = total;
-            }
-        }
+        row_kernels().add_saturate(result.data[i], data[i], other.data[i], width);
     }
-
     return result;
 }
 
 
 // Subtraction operator
 GrayscaleImage GrayscaleImage::operator-(const GrayscaleImage& other) const {
-    // Create a new image for the result
-    GrayscaleImage result(width, height);
-    
-    //substract pixels of two images
+    check_same_size(other);
+
+    //write the clamped differences straight into the rows of the new image
+    GrayscaleImage result(width, height, Uninitialized());
     for (int i = 0; i < height; ++i) {
-        for (int j = 0; j < width; ++j) {
-            int difference = data[i][j] - other.data[i][j];
-            if (difference < 0) { //pixel values have to be in [0,255] range
-                result.data[i][j] = 0;
-            } else {
-            result.data[i][j] = difference;
-            }
-        }
+        row_kernels().sub_saturate(result.data[i], data[i], other.data[i], width);
     }
-
     return result;
 }
 
+// In-place saturating addition
+GrayscaleImage& GrayscaleImage::operator+=(const GrayscaleImage& other) {
+    check_same_size(other);
+
+    //pixel values above 255 are clamped to 255
+    for (int i = 0; i < height; ++i) {
+        row_kernels().add_saturate(data[i], data[i], other.data[i], width);
+    }
+
+    return *this;
+}
+
+// In-place saturating subtraction
+GrayscaleImage& GrayscaleImage::operator-=(const GrayscaleImage& other) {
+    check_same_size(other);
+
+    //pixel values below 0 are clamped to 0
+    for (int i = 0; i < height; ++i) {
+        row_kernels().sub_saturate(data[i], data[i], other.data[i], width);
+    }
+
+    return *this;
+}
+
+// In-place absolute difference
+GrayscaleImage& GrayscaleImage::abs_diff(const GrayscaleImage& other) {
+    check_same_size(other);
+
+    for (int i = 0; i < height; ++i) {
+        row_kernels().abs_diff(data[i], data[i], other.data[i], width);
+    }
+
+    return *this;
+}
+
+// In-place weighted blend
+GrayscaleImage& GrayscaleImage::blend(const GrayscaleImage& other, double weight) {
+    check_same_size(other);
+
+    //the weight is quantized to 1/256 steps so the blend stays in integer arithmetic
+    int fixedWeight = static_cast<int>(std::clamp(weight, 0.0, 1.0) * 256.0 + 0.5);
+
+    for (int i = 0; i < height; ++i) {
+        row_kernels().blend(data[i], data[i], other.data[i], fixedWeight, width);
+    }
+
+    return *this;
+}
+
+// Throws if the other image does not have the same dimensions
+void GrayscaleImage::check_same_size(const GrayscaleImage& other) const {
+    if (width != other.width || height != other.height) {
+        throw std::invalid_argument("Images must have the same dimensions.");
+    }
+}
+
 // Get a specific pixel value
 int GrayscaleImage::get_pixel(int row, int col) const {
     return data[row][col];
@@ -193,3 +386,26 @@ void GrayscaleImage::save_to_file(const char* filename) const {
     delete[] imageBuffer;
 }
 
+// Function to encode the image as PNG into a memory buffer
+std::vector<unsigned char> GrayscaleImage::encode_png() const {
+    // Create a buffer to hold the image data in the format stb_image_write expects
+    std::vector<unsigned char> imageBuffer(static_cast<size_t>(width) * height);
+
+    // Fill the buffer with pixel data (convert int to unsigned char)
+    for (int i = 0; i < height; ++i) {
+        for (int j = 0; j < width; ++j) {
+            imageBuffer[i * width + j] = static_cast<unsigned char>(data[i][j]);
+        }
+    }
+
+    // Encode the buffer, stb allocates the PNG stream with malloc
+    int length = 0;
+    unsigned char* png = stbi_write_png_to_mem(imageBuffer.data(), width, width, height, 1, &length);
+    if (png == nullptr) {
+        throw std::runtime_error("Could not encode image as PNG.");
+    }
+
+    std::vector<unsigned char> encoded(png, png + length);
+    STBIW_FREE(png);
+    return encoded;
+}
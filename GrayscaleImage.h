@@ -1,16 +1,27 @@
 #ifndef GRAYSCALE_IMAGE_H
 #define GRAYSCALE_IMAGE_H
 
+#include <vector>
+
 class GrayscaleImage {
 private:
     int** data; 
     int width, height; 
 
+    // Throws std::invalid_argument if the other image has different dimensions
+    void check_same_size(const GrayscaleImage& other) const;
+
+    // Constructor: allocates the rows without initializing them, for results that overwrite every pixel
+    struct Uninitialized {};
+    GrayscaleImage(int w, int h, Uninitialized);
 
 public:
     // Constructor: loads an image from a file
     GrayscaleImage(const char* filename);
 
+    // Constructor: decodes an image from an in-memory encoded buffer (PNG, JPG, ...)
+    GrayscaleImage(const unsigned char* buffer, int length);
+
     // Constructor: initializes from a 2D data matrix
     GrayscaleImage(int** inputData, int h, int w);
 
@@ -28,6 +39,12 @@ public:
     GrayscaleImage operator+(const GrayscaleImage& other) const;
     GrayscaleImage operator-(const GrayscaleImage& other) const;
 
+    // In-place variants: modify this image without allocating a result
+    GrayscaleImage& operator+=(const GrayscaleImage& other); // saturates at 255
+    GrayscaleImage& operator-=(const GrayscaleImage& other); // saturates at 0
+    GrayscaleImage& abs_diff(const GrayscaleImage& other);   // |this - other|
+    GrayscaleImage& blend(const GrayscaleImage& other, double weight); // (1 - weight) * this + weight * other
+
     // Method to get image dimensions
     int get_width() const { return width; }
     int get_height() const { return height; }
@@ -41,6 +58,9 @@ public:
     // Function to write the image data back to a PNG file
     void save_to_file(const char* filename) const;
 
+    // Function to encode the image data as PNG into a memory buffer
+    std::vector<unsigned char> encode_png() const;
+
     // Getter function for data.
     int** get_data() const {
         return data;
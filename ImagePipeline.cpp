@@ -0,0 +1,277 @@
+#include "ImagePipeline.h"
+#include "BoundedQueue.h"
+#include "TaskScheduler.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+namespace {
+
+// One image travelling through the pipeline
+struct Job {
+    std::string input_path;
+    std::string output_path;
+    std::vector<unsigned char> bytes;      // encoded file contents (before decode / after encode)
+    std::unique_ptr<GrayscaleImage> image; // decoded pixels (between decode and encode)
+};
+
+// Starts `count` threads running `work`; the last thread to finish closes `output`
+// so the next stage sees end-of-stream once everything upstream is drained.
+template <typename Work>
+void start_stage(std::vector<std::thread>& threads, int count, BoundedQueue<Job>& output, Work work) {
+    count = std::max(1, count);
+    auto remaining = std::make_shared<std::atomic<int>>(count);
+    for (int i = 0; i < count; ++i) {
+        threads.emplace_back([remaining, &output, work]() {
+            work();
+            if (remaining->fetch_sub(1) == 1) {
+                output.close();
+            }
+        });
+    }
+}
+
+// Counts images between the CPU stages and the end of the write stage
+class InFlightLimit {
+private:
+    int limit;
+    int count;
+    std::mutex mutex;
+    std::condition_variable released;
+
+public:
+    explicit InFlightLimit(int limit) : limit(limit), count(0) {}
+
+    // Wait for a free slot
+    void acquire() {
+        std::unique_lock<std::mutex> lock(mutex);
+        released.wait(lock, [this] { return count < limit; });
+        count++;
+    }
+
+    // Give a slot back once an image is written or dropped
+    void release() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            count--;
+        }
+        released.notify_one();
+    }
+};
+
+// Closes every queue and joins every stage thread when run() returns or throws, so no exception
+// can leave a joinable std::thread behind. Closing makes blocked producers and consumers give up.
+class StageShutdown {
+private:
+    std::vector<std::thread>& threads;
+    std::vector<BoundedQueue<Job>*> queues;
+
+public:
+    StageShutdown(std::vector<std::thread>& threads, std::vector<BoundedQueue<Job>*> queues)
+        : threads(threads), queues(std::move(queues)) {}
+
+    ~StageShutdown() {
+        for (BoundedQueue<Job>* queue : queues) {
+            queue->close();
+        }
+        for (std::thread& thread : threads) {
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
+    }
+
+    StageShutdown(const StageShutdown&) = delete;
+    StageShutdown& operator=(const StageShutdown&) = delete;
+};
+
+// Read a whole file into memory
+std::vector<unsigned char> read_file(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Could not open file for reading.");
+    }
+    return std::vector<unsigned char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+// Write a memory buffer to a file
+void write_file(const std::string& path, const std::vector<unsigned char>& bytes) {
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    if (!file) {
+        throw std::runtime_error("Could not write file.");
+    }
+}
+
+// Output path for every input: output_dir/<stem>.png, or output_dir/<file name>.png for inputs that
+// share a stem (a.jpg and a.png become a.jpg.png and a.png.png). Throws if two inputs still collide.
+std::vector<std::string> output_paths(const std::vector<std::string>& input_files, const std::string& output_dir) {
+    std::map<std::string, int> stemCount;
+    for (const std::string& input : input_files) {
+        stemCount[std::filesystem::path(input).stem().string()]++;
+    }
+
+    std::vector<std::string> outputs;
+    std::set<std::string> used;
+    for (const std::string& input : input_files) {
+        std::filesystem::path inputPath(input);
+        std::string name = stemCount[inputPath.stem().string()] > 1 ? inputPath.filename().string()
+                                                                    : inputPath.stem().string();
+        std::filesystem::path output(output_dir);
+        output /= name + ".png";
+
+        if (!used.insert(output.string()).second) {
+            throw std::invalid_argument("Several input files would be written to " + output.string());
+        }
+        outputs.push_back(output.string());
+    }
+    return outputs;
+}
+
+} // namespace
+
+// Constructor: default stage configuration
+ImagePipeline::ImagePipeline() : config() {}
+
+// Constructor: store the stage configuration
+ImagePipeline::ImagePipeline(const Config& config) : config(config) {}
+
+// Append a step to the filter chain
+void ImagePipeline::add_filter(const FilterStep& step) {
+    filters.push_back(step);
+}
+
+// Process every regular file of a directory, in name order
+ImagePipeline::Stats ImagePipeline::run(const std::string& input_dir, const std::string& output_dir) const {
+    std::vector<std::string> input_files;
+    for (const auto& entry : std::filesystem::directory_iterator(input_dir)) {
+        if (entry.is_regular_file()) {
+            input_files.push_back(entry.path().string());
+        }
+    }
+    std::sort(input_files.begin(), input_files.end());
+
+    return run(input_files, output_dir);
+}
+
+// Process a list of files through read -> decode -> filter -> encode -> write
+ImagePipeline::Stats ImagePipeline::run(const std::vector<std::string>& input_files, const std::string& output_dir) const {
+    // Resolve every output name up front so no image silently overwrites another one
+    std::vector<std::string> outputs = output_paths(input_files, output_dir);
+    std::filesystem::create_directories(output_dir);
+
+    TaskScheduler& scheduler = TaskScheduler::instance();
+    int cpuTasks = config.cpu_tasks > 0 ? config.cpu_tasks : 2 * scheduler.get_thread_count();
+
+    // At most cpuTasks images are between the CPU stages and the end of the write stage,
+    // so pushing to the encoded queue from a scheduler task never blocks a worker
+    BoundedQueue<Job> read_queue(config.queue_capacity);
+    BoundedQueue<Job> encoded_queue(cpuTasks);
+    BoundedQueue<Job> done_queue(1); // never popped, only closed by the write stage
+    InFlightLimit inFlight(cpuTasks);
+
+    std::atomic<std::size_t> next_file(0);
+    std::atomic<int> written(0);
+    std::atomic<int> failed(0);
+    std::vector<std::thread> threads;
+    StageShutdown shutdown(threads, {&read_queue, &encoded_queue, &done_queue});
+
+    // Stage 1: read encoded bytes from disk
+    start_stage(threads, config.read_threads, read_queue, [&]() {
+        for (std::size_t i = next_file++; i < input_files.size(); i = next_file++) {
+            Job job;
+            job.input_path = input_files[i];
+            job.output_path = outputs[i];
+
+            try {
+                job.bytes = read_file(job.input_path);
+            } catch (const std::exception& e) {
+                std::cerr << "Error: " << job.input_path << ": " << e.what() << std::endl;
+                failed++;
+                continue;
+            }
+            if (!read_queue.push(std::move(job))) {
+                break; // closed early, run() is unwinding
+            }
+        }
+    });
+
+    // Stage 5: write to disk
+    start_stage(threads, config.write_threads, done_queue, [&]() {
+        Job job;
+        while (encoded_queue.pop(job)) {
+            try {
+                write_file(job.output_path, job.bytes);
+                written++;
+            } catch (const std::exception& e) {
+                std::cerr << "Error: " << job.output_path << ": " << e.what() << std::endl;
+                failed++;
+            }
+            inFlight.release();
+        }
+    });
+
+    // Stages 2-4: decode, run the filter chain in place and encode back to PNG
+    auto process = [this, &encoded_queue, &inFlight, &failed](Job& job) {
+        try {
+            job.image.reset(new GrayscaleImage(job.bytes.data(), static_cast<int>(job.bytes.size())));
+            std::vector<unsigned char>().swap(job.bytes);
+            for (const FilterStep& step : filters) {
+                step(*job.image);
+            }
+            job.bytes = job.image->encode_png();
+            job.image.reset();
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << job.input_path << ": " << e.what() << std::endl;
+            failed++;
+            inFlight.release();
+            return;
+        } catch (...) {
+            // A filter step may throw anything; it fails this image, not the run
+            std::cerr << "Error: " << job.input_path << ": unknown exception" << std::endl;
+            failed++;
+            inFlight.release();
+            return;
+        }
+        encoded_queue.push(std::move(job));
+    };
+
+    // This thread feeds the CPU stages. Each image becomes one scheduler task; with a single
+    // scheduler thread there are no workers, so the work runs here instead.
+    {
+        TaskGroup group(scheduler);
+        Job job;
+        while (read_queue.pop(job)) {
+            inFlight.acquire();
+            if (scheduler.get_thread_count() == 1) {
+                process(job);
+                continue;
+            }
+            auto shared = std::make_shared<Job>(std::move(job));
+            group.run([shared, &process]() { process(*shared); });
+        }
+        group.wait();
+    }
+    encoded_queue.close();
+
+    // Wait for the writers before reading the counters
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    Stats stats;
+    stats.written = written;
+    stats.failed = failed;
+    return stats;
+}
@@ -0,0 +1,59 @@
+#ifndef IMAGE_PIPELINE_H
+#define IMAGE_PIPELINE_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "GrayscaleImage.h"
+
+// Runs a chain of in-place filters over every image of a directory.
+// Reading and writing run on their own threads since they block on the disk. Decoding, filtering
+// and encoding are CPU work and run as tasks on the shared TaskScheduler, so the pipeline adds no
+// CPU threads of its own and does not oversubscribe the host when filters use parallel_for too.
+// Bounded queues and a cap on images in flight make a slow stage throttle the ones before it.
+// File I/O only has this thread-based path; there is no io_uring backend. Each image is one whole-file
+// read and one whole-file write, which the I/O threads already overlap with the CPU stages.
+class ImagePipeline {
+public:
+    // A single in-place step, e.g. [](GrayscaleImage& img) { Filter::apply_mean_filter(img, 5); }
+    using FilterStep = std::function<void(GrayscaleImage&)>;
+
+    // Concurrency of each stage and number of images each queue may hold
+    struct Config {
+        int read_threads = 2;             // threads reading files
+        int cpu_tasks = 0;                // images decoded/filtered/encoded at once, <= 0 means 2 per scheduler thread
+        int write_threads = 2;            // threads writing files
+        std::size_t queue_capacity = 16;  // images read ahead of the CPU stages
+    };
+
+    // Result of a run over a directory
+    struct Stats {
+        int written = 0;
+        int failed = 0;
+    };
+
+    // Constructor: uses the default per-stage concurrency and queue sizes
+    ImagePipeline();
+
+    // Constructor: takes the per-stage concurrency and queue sizes
+    explicit ImagePipeline(const Config& config);
+
+    // Append a step to the filter chain, steps run in the order they were added
+    void add_filter(const FilterStep& step);
+
+    // Process every regular file in input_dir and write the results as PNG into output_dir
+    Stats run(const std::string& input_dir, const std::string& output_dir) const;
+
+    // Process an explicit list of input files, writing each one as output_dir/<stem>.png.
+    // Inputs sharing a stem keep their extension instead (a.jpg -> a.jpg.png, a.png -> a.png.png).
+    // Throws std::invalid_argument before processing anything if two inputs still map to the same file.
+    Stats run(const std::vector<std::string>& input_files, const std::string& output_dir) const;
+
+private:
+    Config config;
+    std::vector<FilterStep> filters;
+};
+
+#endif // IMAGE_PIPELINE_H
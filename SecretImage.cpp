@@ -1,5 +1,10 @@
 #include "SecretImage.h"
+#include "TaskScheduler.h"
 
+// Rows per scheduler task, so that every task copies at least TaskScheduler::kMinElementsPerTask pixels
+static int rows_per_task(int width) {
+    return std::max(1, TaskScheduler::kMinElementsPerTask / std::max(1, width));
+}
 
 // Constructor: split image into upper and lower triangular arrays
 SecretImage::SecretImage(const GrayscaleImage& image) {
@@ -16,21 +21,23 @@ SecretImage::SecretImage(const GrayscaleImage& image) {
     lower_triangular = new int[sizeOfLower];
 
     // 2. Fill both matrices with the pixels from the GrayscaleImage.
-    for (int i = 0; i < height; ++i) {
-        for (int j = 0; j < width; ++j) {
-            int pixelValue = image.get_pixel(i, j);
-
-            if (i <= j) {
-                //upper triangular matrix
-                int indexOfUpper = (i * width - (i * (i - 1)) / 2) + (j - i);
-                upper_triangular[indexOfUpper] = pixelValue;            
-            } else {
-                //lower triangular matrix
-                int indexOfLower = (i * (i - 1)) / 2 + j;
-                lower_triangular[indexOfLower] = pixelValue;            
+    TaskScheduler::instance().parallel_for(0, height, [&](int rowBegin, int rowEnd) {
+        for (int i = rowBegin; i < rowEnd; ++i) {
+            for (int j = 0; j < width; ++j) {
+                int pixelValue = image.get_pixel(i, j);
+
+                if (i <= j) {
+                    //upper triangular matrix
+                    int indexOfUpper = (i * width - (i * (i - 1)) / 2) + (j - i);
+                    upper_triangular[indexOfUpper] = pixelValue;            
+                } else {
+                    //lower triangular matrix
+                    int indexOfLower = (i * (i - 1)) / 2 + j;
+                    lower_triangular[indexOfLower] = pixelValue;            
+                }
             }
         }
-    }
+    }, rows_per_task(width));
 }
 
 // Constructor: instantiate based on data read from file
@@ -54,19 +61,21 @@ GrayscaleImage SecretImage::reconstruct() const {
     GrayscaleImage image(width, height);
 
     //fill the image with pixel values from upper and lower triangular matrices
-   for (int i = 0; i < height; ++i) {
-        for (int j = 0; j < width; ++j) {
-            if (i <= j) {
-                //get value from the upper triangular matrix (i <= j)
-                int upperIndex = (i * width - (i * (i - 1)) / 2) + (j - i);
-                image.set_pixel(i, j, upper_triangular[upperIndex]);
-            } else {
-                //get value from the lower triangular matrix (i > j)
-                int lowerIndex = (i * (i - 1)) / 2 + j;
-                image.set_pixel(i, j, lower_triangular[lowerIndex]);
+    TaskScheduler::instance().parallel_for(0, height, [&](int rowBegin, int rowEnd) {
+        for (int i = rowBegin; i < rowEnd; ++i) {
+            for (int j = 0; j < width; ++j) {
+                if (i <= j) {
+                    //get value from the upper triangular matrix (i <= j)
+                    int upperIndex = (i * width - (i * (i - 1)) / 2) + (j - i);
+                    image.set_pixel(i, j, upper_triangular[upperIndex]);
+                } else {
+                    //get value from the lower triangular matrix (i > j)
+                    int lowerIndex = (i * (i - 1)) / 2 + j;
+                    image.set_pixel(i, j, lower_triangular[lowerIndex]);
+                }
             }
         }
-    }
+    }, rows_per_task(width));
 
     return image;
 }
@@ -75,21 +84,48 @@ GrayscaleImage SecretImage::reconstruct() const {
 void SecretImage::save_back(const GrayscaleImage& image) {
 
     //recalculate the triangular arrays from the modified image
-    for (int i = 0; i < height; ++i) {
-        for (int j = 0; j < width; ++j) {
-            int pixel_value = image.get_pixel(i, j);
-
-            if (i <= j) {
-                //save pixel value to the upper triangular matrix
-                int index = (i * width - (i * (i - 1)) / 2) + (j - i);
-                upper_triangular[index] = pixel_value;
-            } else {
-                //save pixel value to the lower triangular matrix
-                int index = (i * (i - 1)) / 2 + j;
-                lower_triangular[index] = pixel_value;
+    TaskScheduler::instance().parallel_for(0, height, [&](int rowBegin, int rowEnd) {
+        for (int i = rowBegin; i < rowEnd; ++i) {
+            for (int j = 0; j < width; ++j) {
+                int pixel_value = image.get_pixel(i, j);
+
+                if (i <= j) {
+                    //save pixel value to the upper triangular matrix
+                    int index = (i * width - (i * (i - 1)) / 2) + (j - i);
+                    upper_triangular[index] = pixel_value;
+                } else {
+                    //save pixel value to the lower triangular matrix
+                    int index = (i * (i - 1)) / 2 + j;
+                    lower_triangular[index] = pixel_value;
+                }
+            }
+        }
+    }, rows_per_task(width));
+}
+
+// Formats values as "v0 v1 ... vn-1 " (each value followed by a space). Chunks are
+// formatted in parallel and concatenated in order, so the output matches a serial loop.
+static std::string format_values(const int* values, int count) {
+    const int chunkSize = 1 << 16;
+    int chunkCount = (count + chunkSize - 1) / chunkSize;
+    std::vector<std::string> chunks(chunkCount);
+
+    TaskScheduler::instance().parallel_for(0, chunkCount, [&](int chunkBegin, int chunkEnd) {
+        for (int chunk = chunkBegin; chunk < chunkEnd; ++chunk) {
+            std::ostringstream stream;
+            int end = std::min(count, (chunk + 1) * chunkSize);
+            for (int i = chunk * chunkSize; i < end; ++i) {
+                stream << values[i] << " ";
             }
+            chunks[chunk] = stream.str();
         }
+    }, 1);
+
+    std::string text;
+    for (const std::string& chunk : chunks) {
+        text += chunk;
     }
+    return text;
 }
 
 // Save the upper and lower triangular arrays to a file
@@ -102,17 +138,13 @@ void SecretImage::save_to_file(const std::string& filename) {
 
     // Write the upper_triangular array to the second line.
     int upper_size = (width * (width + 1)) / 2;
-    for (int i = 0; i < upper_size; ++i) {
-        file << upper_triangular[i] << " ";
-    }
+    file << format_values(upper_triangular, upper_size);
     file << "\n";
 
     // Write the lower_triangular array to the third line in a similar manner
     // as the second line.
     int lower_size = (width * (width - 1)) / 2;
-    for (int i = 0; i < lower_size; ++i) {
-        file << lower_triangular[i] << " ";
-    }
+    file << format_values(lower_triangular, lower_size);
     file.close();
 }
 
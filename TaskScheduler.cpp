@@ -0,0 +1,311 @@
+#include "TaskScheduler.h"
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+// Identifies the scheduler and deque owned by the calling worker thread
+thread_local const TaskScheduler* worker_owner = nullptr;
+thread_local int worker_index = -1;
+
+// Failed attempts to find work before a waiting thread blocks instead of spinning
+const int kSpinCount = 64;
+
+// CPUs the process is allowed to run on
+std::vector<int> allowed_cpus() {
+    std::vector<int> cpus;
+#if defined(__linux__)
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    if (sched_getaffinity(0, sizeof(cpu_set_t), &mask) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &mask)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+#endif
+    return cpus;
+}
+
+} // namespace
+
+// Returns the shared scheduler, created on first use and never replaced
+TaskScheduler& TaskScheduler::instance() {
+    static TaskScheduler scheduler;
+    return scheduler;
+}
+
+// Resize the shared scheduler in place
+bool TaskScheduler::configure(int threadCount, bool pinThreads) {
+    TaskScheduler& scheduler = instance();
+    std::lock_guard<std::mutex> lock(scheduler.configure_mutex);
+
+    if (scheduler.queued.load() > 0 || scheduler.running.load() > 0) {
+        throw std::logic_error("TaskScheduler::configure called while tasks are pending.");
+    }
+
+    scheduler.stop_workers();
+    return scheduler.start_workers(threadCount, pinThreads);
+}
+
+// Constructor: one thread per CPU
+TaskScheduler::TaskScheduler() : thread_count(1), queued(0), running(0), stopping(false) {
+    start_workers(0, false);
+}
+
+// Destructor: stop and join the workers
+TaskScheduler::~TaskScheduler() {
+    stop_workers();
+}
+
+// Start threadCount - 1 workers, the thread that waits on a group is the last one
+bool TaskScheduler::start_workers(int threadCount, bool pinThreads) {
+    if (threadCount <= 0) {
+        threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+
+    // Create every deque before any worker starts stealing from them
+    for (int i = 0; i < threadCount - 1; ++i) {
+        workers.emplace_back(new Worker());
+    }
+    for (int i = 0; i < threadCount - 1; ++i) {
+        workers[i]->thread = std::thread(&TaskScheduler::worker_loop, this, i);
+    }
+    thread_count = threadCount;
+
+    if (!pinThreads) {
+        return true;
+    }
+
+#if defined(__linux__)
+    // Only pin to CPUs in the process mask, a restricted cpuset would reject the others
+    std::vector<int> cpus = allowed_cpus();
+    if (cpus.empty()) {
+        return false;
+    }
+
+    bool pinned = true;
+    for (int i = 0; i < threadCount - 1; ++i) {
+        cpu_set_t mask;
+        CPU_ZERO(&mask);
+        CPU_SET(cpus[i % cpus.size()], &mask);
+        if (pthread_setaffinity_np(workers[i]->thread.native_handle(), sizeof(cpu_set_t), &mask) != 0) {
+            pinned = false;
+        }
+    }
+    return pinned;
+#else
+    return false;
+#endif
+}
+
+// Stop and join every worker, leaving an empty (inline only) scheduler
+void TaskScheduler::stop_workers() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        stopping = true;
+    }
+    wake_up.notify_all();
+
+    for (std::unique_ptr<Worker>& worker : workers) {
+        worker->thread.join();
+    }
+    workers.clear();
+    thread_count = 1;
+    stopping = false;
+}
+
+// Split a range into chunks and run them in parallel
+void TaskScheduler::parallel_for(int begin, int end, const std::function<void(int, int)>& body, int grain) {
+    int count = end - begin;
+    if (count <= 0) {
+        return;
+    }
+
+    // Aim for about four chunks per thread so stealing can even out uneven rows
+    int threads = get_thread_count();
+    if (grain <= 0) {
+        grain = std::max(1, count / (4 * threads));
+    }
+
+    // Nothing to split, run inline without touching the queues
+    if (count <= grain || threads == 1) {
+        body(begin, end);
+        return;
+    }
+
+    TaskGroup group(*this);
+    for (int chunkBegin = begin; chunkBegin < end; chunkBegin += grain) {
+        int chunkEnd = std::min(end, chunkBegin + grain);
+        group.run([&body, chunkBegin, chunkEnd]() { body(chunkBegin, chunkEnd); });
+    }
+    group.wait();
+}
+
+// Queue a task on the caller's own deque, or on the shared queue for outside threads
+void TaskScheduler::submit(Task task) {
+    int index = current_worker();
+    if (index >= 0) {
+        std::lock_guard<std::mutex> lock(workers[index]->mutex);
+        workers[index]->tasks.push_back(std::move(task));
+    } else {
+        std::lock_guard<std::mutex> lock(injected_mutex);
+        injected.push_back(std::move(task));
+    }
+    queued++;
+
+    // Taking the sleep mutex orders this push before a sleeper's decision to block
+    { std::lock_guard<std::mutex> lock(sleep_mutex); }
+    wake_up.notify_one();
+}
+
+// Find and run one task, returns false if every queue was empty
+bool TaskScheduler::run_one() {
+    Task task;
+    if (!take(task)) {
+        return false;
+    }
+    execute(task);
+    return true;
+}
+
+// Own deque (newest first), then the shared queue, then steal the oldest task of another worker
+bool TaskScheduler::take(Task& task) {
+    if (queued.load() == 0) {
+        return false;
+    }
+
+    int index = current_worker();
+    if (index >= 0) {
+        Worker& self = *workers[index];
+        std::lock_guard<std::mutex> lock(self.mutex);
+        if (!self.tasks.empty()) {
+            task = std::move(self.tasks.back());
+            self.tasks.pop_back();
+            queued--;
+            return true;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(injected_mutex);
+        if (!injected.empty()) {
+            task = std::move(injected.front());
+            injected.pop_front();
+            queued--;
+            return true;
+        }
+    }
+
+    // Start at the next worker so thieves do not all hit worker 0
+    int workerCount = static_cast<int>(workers.size());
+    for (int k = 1; k <= workerCount; ++k) {
+        int victim = (index + k + workerCount) % workerCount;
+        if (victim == index) {
+            continue;
+        }
+        Worker& other = *workers[victim];
+        std::lock_guard<std::mutex> lock(other.mutex);
+        if (!other.tasks.empty()) {
+            task = std::move(other.tasks.front());
+            other.tasks.pop_front();
+            queued--;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Run a task and record its completion (and first exception) in its group
+void TaskScheduler::execute(Task& task) {
+    running++;
+    try {
+        task.function();
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(task.group->error_mutex);
+        if (!task.group->error) {
+            task.group->error = std::current_exception();
+        }
+    }
+    running--;
+
+    // The group may be destroyed as soon as pending reaches 0, only the scheduler is used afterwards
+    if (task.group->pending.fetch_sub(1) == 1) {
+        { std::lock_guard<std::mutex> lock(sleep_mutex); }
+        wake_up.notify_all();
+    }
+}
+
+// Help with any queued work until the group is done; block once there is nothing left to help with
+void TaskScheduler::wait_for(TaskGroup& group) {
+    int idle = 0;
+    while (group.pending.load() > 0) {
+        if (run_one()) {
+            idle = 0;
+            continue;
+        }
+        if (++idle < kSpinCount) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleep_mutex);
+        wake_up.wait(lock, [this, &group] { return group.pending.load() == 0 || queued.load() > 0; });
+        idle = 0;
+    }
+}
+
+// Worker thread: run tasks until the scheduler stops, sleep while there is nothing to do
+void TaskScheduler::worker_loop(int index) {
+    worker_owner = this;
+    worker_index = index;
+
+    while (true) {
+        if (run_one()) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleep_mutex);
+        wake_up.wait(lock, [this] { return stopping || queued.load() > 0; });
+        if (stopping) {
+            return;
+        }
+    }
+}
+
+// Index of the calling worker in this scheduler, -1 for any other thread
+int TaskScheduler::current_worker() const {
+    return worker_owner == this ? worker_index : -1;
+}
+
+// Constructor: empty group on the given scheduler
+TaskGroup::TaskGroup(TaskScheduler& scheduler) : scheduler(scheduler), pending(0) {}
+
+// Destructor: never leave tasks referring to a destroyed group
+TaskGroup::~TaskGroup() {
+    scheduler.wait_for(*this);
+}
+
+// Schedule a task in this group
+void TaskGroup::run(std::function<void()> function) {
+    pending++;
+    scheduler.submit(TaskScheduler::Task{std::move(function), this});
+}
+
+// Run tasks (from any group) until this group is done, then report the first failure
+void TaskGroup::wait() {
+    scheduler.wait_for(*this);
+
+    if (error) {
+        std::exception_ptr failure = error;
+        error = nullptr;
+        std::rethrow_exception(failure);
+    }
+}
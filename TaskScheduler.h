@@ -0,0 +1,115 @@
+#ifndef TASK_SCHEDULER_H
+#define TASK_SCHEDULER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class TaskGroup;
+
+// Process-wide work-stealing scheduler shared by Filter, Crypto, SecretImage and ImagePipeline so
+// that parallel code never creates its own threads. Each worker owns a deque: it pushes and pops
+// at the back, idle workers steal from the front of the others. Threads that are not workers
+// submit through a shared queue and help run tasks while they wait.
+class TaskScheduler {
+public:
+    // Returns the shared scheduler. It is created once, on first use, with one thread per CPU
+    // and lives until the end of the program, so references to it never dangle.
+    static TaskScheduler& instance();
+
+    // Resize the shared scheduler to threadCount threads (including the calling thread, so 1
+    // means everything runs inline). threadCount <= 0 picks the hardware concurrency.
+    // When pinThreads is set, worker i is bound to the i-th CPU the process may run on (Linux only).
+    // Throws std::logic_error if tasks are queued or running.
+    // Returns false if pinning was requested and a worker could not be pinned (it then runs unpinned).
+    static bool configure(int threadCount, bool pinThreads = false);
+
+    // Elements of simple per-pixel work worth one task: a task costs well under a microsecond to schedule,
+    // this much work takes several. Loops over cheap elements pass it (or rows holding it) as grain.
+    static constexpr int kMinElementsPerTask = 16384;
+
+    // Number of threads that execute tasks, including the caller
+    int get_thread_count() const { return thread_count.load(); }
+
+    // Split [begin, end) into chunks of at least `grain` indices and call body(chunkBegin, chunkEnd)
+    // for each one in parallel. Returns when all chunks are done and rethrows the first exception.
+    // grain <= 0 picks a chunk size that gives every thread a few chunks.
+    void parallel_for(int begin, int end, const std::function<void(int, int)>& body, int grain = 0);
+
+    ~TaskScheduler();
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+private:
+    friend class TaskGroup;
+
+    struct Task {
+        std::function<void()> function;
+        TaskGroup* group;
+    };
+
+    struct Worker {
+        std::deque<Task> tasks;
+        std::mutex mutex;
+        std::thread thread;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<int> thread_count;
+    std::deque<Task> injected; // tasks submitted from threads that are not workers
+    std::mutex injected_mutex;
+
+    std::atomic<int> queued;   // tasks sitting in any queue
+    std::atomic<int> running;  // tasks currently executing
+    std::atomic<bool> stopping;
+    std::mutex sleep_mutex;    // guards sleeping workers and blocked waiters
+    std::condition_variable wake_up;
+    std::mutex configure_mutex;
+
+    TaskScheduler();
+
+    bool start_workers(int threadCount, bool pinThreads);
+    void stop_workers();
+    void submit(Task task);
+    bool run_one();              // run a single pending task if one can be found
+    bool take(Task& task);       // own deque, then the shared queue, then steal
+    void execute(Task& task);
+    void wait_for(TaskGroup& group);
+    void worker_loop(int index);
+    int current_worker() const;  // index of the calling worker, -1 for other threads
+};
+
+// A set of tasks that can be waited on together
+class TaskGroup {
+public:
+    explicit TaskGroup(TaskScheduler& scheduler = TaskScheduler::instance());
+
+    // Waits for outstanding tasks so none outlive the group
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    // Schedule a task in this group
+    void run(std::function<void()> function);
+
+    // Help run tasks until every task of the group has finished, then rethrow the first exception
+    void wait();
+
+private:
+    friend class TaskScheduler;
+
+    TaskScheduler& scheduler;
+    std::atomic<int> pending;
+    std::exception_ptr error;
+    std::mutex error_mutex;
+};
+
+#endif // TASK_SCHEDULER_H
@@ -0,0 +1,97 @@
+#include "GrayscaleImage.h"
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+
+// Image arithmetic throughput against the original scalar operators (reproduced below).
+// Usage: arithmetic_bench [width height]
+//
+// operator+ and operator- allocate their result. glibc hands the freed image back to the OS, so every
+// result page-faults its memory in again and that dominates their time. To time the arithmetic alone run
+//   MALLOC_TRIM_THRESHOLD_=1000000000 MALLOC_TOP_PAD_=100000000 arithmetic_bench
+
+using Clock = std::chrono::steady_clock;
+
+// operator+ as it was before the row kernels: fresh image, branch per pixel
+static GrayscaleImage original_add(const GrayscaleImage& a, const GrayscaleImage& b) {
+    GrayscaleImage result(a.get_width(), a.get_height());
+    int** out = result.get_data();
+    int** x = a.get_data();
+    int** y = b.get_data();
+    for (int i = 0; i < a.get_height(); ++i) {
+        for (int j = 0; j < a.get_width(); ++j) {
+            int total = x[i][j] + y[i][j];
+            if (total > 255) {
+                out[i][j] = 255;
+            } else {
+                out[i][j] = total;
+            }
+        }
+    }
+    return result;
+}
+
+// operator== as it was before: element by element
+static bool original_equal(const GrayscaleImage& a, const GrayscaleImage& b) {
+    for (int i = 0; i < a.get_height(); ++i) {
+        for (int j = 0; j < a.get_width(); ++j) {
+            if (a.get_pixel(i, j) != b.get_pixel(i, j)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Average milliseconds per call of `body` over `rounds` calls
+static double time_ms(int rounds, const std::function<void()>& body) {
+    Clock::time_point start = Clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        body();
+    }
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count() / rounds;
+}
+
+int main(int argc, char** argv) {
+    int width = argc > 2 ? std::atoi(argv[1]) : 1920;
+    int height = argc > 2 ? std::atoi(argv[2]) : 1080;
+    const int rounds = 50;
+
+    GrayscaleImage a(width, height);
+    GrayscaleImage b(width, height);
+    for (int i = 0; i < height; ++i) {
+        for (int j = 0; j < width; ++j) {
+            a.set_pixel(i, j, (i * 31 + j * 17) % 256);
+            b.set_pixel(i, j, (i * 13 + j * 7) % 256);
+        }
+    }
+    GrayscaleImage same(a);
+    GrayscaleImage work(a);
+    volatile bool sink = false;
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    std::cout << "AVX2 " << (__builtin_cpu_supports("avx2") ? "available" : "not available") << std::endl;
+#endif
+    std::cout << width << "x" << height << ", ms per call" << std::endl;
+
+    double baseAdd = time_ms(rounds, [&]() { GrayscaleImage r = original_add(a, b); });
+    double baseEqual = time_ms(rounds, [&]() { sink = original_equal(a, same); });
+
+    std::cout << "  original operator+   " << baseAdd << std::endl;
+    std::cout << "  operator+            " << time_ms(rounds, [&]() { GrayscaleImage r = a + b; }) << std::endl;
+    std::cout << "  operator-            " << time_ms(rounds, [&]() { GrayscaleImage r = a - b; }) << std::endl;
+
+    double addInPlace = time_ms(rounds, [&]() { work += b; });
+    std::cout << "  operator+=           " << addInPlace << "  (" << baseAdd / addInPlace << "x vs original operator+)" << std::endl;
+    std::cout << "  operator-=           " << time_ms(rounds, [&]() { work -= b; }) << std::endl;
+    std::cout << "  abs_diff             " << time_ms(rounds, [&]() { work.abs_diff(b); }) << std::endl;
+    std::cout << "  blend                " << time_ms(rounds, [&]() { work.blend(b, 0.25); }) << std::endl;
+
+    double equal = time_ms(rounds, [&]() { sink = (a == same); });
+    std::cout << "  original operator==  " << baseEqual << std::endl;
+    std::cout << "  operator==           " << equal << "  (" << baseEqual / equal << "x)" << std::endl;
+
+    (void)sink;
+    return 0;
+}
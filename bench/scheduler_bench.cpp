@@ -0,0 +1,53 @@
+#include "TaskScheduler.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+// Scheduler overhead: time spent submitting and waiting on empty work.
+// Usage: scheduler_bench [threads] (default: hardware concurrency), always also measures 1 thread.
+
+using Clock = std::chrono::steady_clock;
+
+static double elapsed_ns(Clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+// TaskGroup run + wait on `tasks` empty tasks, repeated `rounds` times
+static void bench_task_group(int tasks, int rounds) {
+    Clock::time_point start = Clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        TaskGroup group;
+        for (int t = 0; t < tasks; ++t) {
+            group.run([]() {});
+        }
+        group.wait();
+    }
+    double ns = elapsed_ns(start);
+    std::cout << "  TaskGroup " << tasks << " empty tasks: " << ns / rounds / 1000.0 << " us per group, "
+              << ns / rounds / tasks << " ns per task" << std::endl;
+}
+
+// parallel_for over `rows` empty rows, one row per chunk, repeated `rounds` times
+static void bench_parallel_for(int rows, int rounds) {
+    Clock::time_point start = Clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        TaskScheduler::instance().parallel_for(0, rows, [](int, int) {}, 1);
+    }
+    double ns = elapsed_ns(start);
+    std::cout << "  parallel_for " << rows << " empty rows: " << ns / rounds / 1000.0 << " us per call, "
+              << ns / rounds / rows << " ns per row" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    int threads = argc > 1 ? std::atoi(argv[1]) : static_cast<int>(std::thread::hardware_concurrency());
+
+    for (int count : {1, threads}) {
+        TaskScheduler::configure(count);
+        std::cout << TaskScheduler::instance().get_thread_count() << " thread(s)" << std::endl;
+        bench_task_group(8, 20000);
+        bench_task_group(1024, 200);
+        bench_parallel_for(1080, 200);
+    }
+    return 0;
+}
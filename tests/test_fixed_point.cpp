@@ -0,0 +1,62 @@
+#include "Filter.h"
+#include "test_util.h"
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+// Gaussian bound documented in Filter.h: ceil(255 * kernelSize^2 / 2^17) gray levels
+static int gaussian_bound(int kernelSize) {
+    return (255 * kernelSize * kernelSize + (1 << 17) - 1) >> 17;
+}
+
+// Unsharp bound documented in Filter.h: ceil(|amount| * E + 0.5) gray levels
+static int unsharp_bound(int kernelSize, double amount) {
+    return static_cast<int>(std::ceil(std::fabs(amount) * gaussian_bound(kernelSize) + 0.5));
+}
+
+// Compared with the direct convolution, so sigmas the pyramid would take still check the bound itself
+static void test_gaussian_bound() {
+    for (int kernelSize = 3; kernelSize <= 25; kernelSize += 2) {
+        for (double sigma : {0.5, 1.0, 2.0, 3.5, 6.0, 12.0}) {
+            for (int pattern = 0; pattern < kTestPatternCount; ++pattern) {
+                GrayscaleImage fixed = make_test_image(57, 43, pattern, 4);
+                GrayscaleImage direct(fixed);
+                Filter::apply_gaussian_smoothing_fixed(fixed, kernelSize, sigma);
+                Filter::apply_gaussian_smoothing_direct(direct, kernelSize, sigma);
+
+                int error = max_difference(fixed, direct);
+                if (error > gaussian_bound(kernelSize)) {
+                    std::cerr << "gaussian K=" << kernelSize << " sigma=" << sigma << " pattern " << pattern
+                              << ": off by " << error << ", bound " << gaussian_bound(kernelSize) << std::endl;
+                }
+                CHECK(error <= gaussian_bound(kernelSize));
+            }
+        }
+    }
+}
+
+static void test_unsharp_bound() {
+    for (int kernelSize = 3; kernelSize <= 25; kernelSize += 2) {
+        for (double amount : {0.5, 1.0, 1.5, 2.0, 3.0}) {
+            for (int pattern = 0; pattern < kTestPatternCount; ++pattern) {
+                GrayscaleImage fixed = make_test_image(57, 43, pattern, 4);
+                GrayscaleImage direct(fixed);
+                Filter::apply_unsharp_mask_fixed(fixed, kernelSize, amount);
+                Filter::apply_unsharp_mask(direct, kernelSize, amount);
+
+                int error = max_difference(fixed, direct);
+                if (error > unsharp_bound(kernelSize, amount)) {
+                    std::cerr << "unsharp K=" << kernelSize << " amount=" << amount << " pattern " << pattern
+                              << ": off by " << error << ", bound " << unsharp_bound(kernelSize, amount) << std::endl;
+                }
+                CHECK(error <= unsharp_bound(kernelSize, amount));
+            }
+        }
+    }
+}
+
+int main() {
+    test_gaussian_bound();
+    test_unsharp_bound();
+    return test_failures() == 0 ? 0 : 1;
+}
@@ -0,0 +1,129 @@
+#include "Filter.h"
+#include "GaussianPyramid.h"
+#include "TaskScheduler.h"
+#include "test_util.h"
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+// Documented bound between the pyramid and the direct convolution, border included
+const int kMaxError = 2;
+
+// Bytes allocated through the replaced global operator new below
+static std::atomic<std::size_t> allocatedBytes(0);
+
+void* operator new(std::size_t size) {
+    allocatedBytes += size;
+    if (void* memory = std::malloc(size == 0 ? 1 : size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+// +-3 sigma kernels are routed through the pyramid and stay within kMaxError of the direct path
+static void test_matches_direct_path() {
+    const int sizes[][2] = {{160, 120}, {97, 131}, {40, 300}};
+    for (const auto& size : sizes) {
+        for (double sigma : {2.5, 4.0, 6.0, 12.0}) {
+            int kernelSize = 2 * static_cast<int>(std::ceil(3.0 * sigma)) + 1;
+            if (GaussianPyramid::levels_for_sigma(size[0], size[1], kernelSize, sigma) == 0) {
+                continue;
+            }
+            for (int pattern = 0; pattern < kTestPatternCount; ++pattern) {
+                GrayscaleImage pyramid = make_test_image(size[0], size[1], pattern);
+                GrayscaleImage direct(pyramid);
+                Filter::apply_gaussian_smoothing(pyramid, kernelSize, sigma);
+                Filter::apply_gaussian_smoothing_direct(direct, kernelSize, sigma);
+
+                int error = max_difference(pyramid, direct);
+                if (error > kMaxError) {
+                    std::cerr << size[0] << "x" << size[1] << " sigma " << sigma << " pattern " << pattern
+                              << ": off by " << error << std::endl;
+                }
+                CHECK(error <= kMaxError);
+            }
+        }
+    }
+}
+
+// Routing: small sigma and kernels narrower than +-3 sigma stay on the direct path
+static void test_routing() {
+    CHECK(GaussianPyramid::levels_for_sigma(160, 120, 3, 1.0) == 0);
+    CHECK(GaussianPyramid::levels_for_sigma(160, 120, 2 * 12 + 1, 6.0) == 0);
+    CHECK(GaussianPyramid::levels_for_sigma(160, 120, 2 * 18 + 1, 6.0) > 0);
+    CHECK(GaussianPyramid::levels_for_sigma(20, 20, 2 * 18 + 1, 6.0) == 0);
+
+    // smooth() refuses what levels_for_sigma would not route
+    GrayscaleImage image(160, 120);
+    GaussianPyramid pyramid;
+    bool threw = false;
+    try {
+        pyramid.smooth(image, 2 * 12 + 1, 6.0, 1);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+// Images blurred from scheduler tasks use nested pyramids and give the same result as one at a time
+static void test_concurrent_calls() {
+    std::vector<GrayscaleImage> images;
+    for (int k = 0; k < 8; ++k) {
+        images.push_back(make_test_image(64 + 8 * k, 80, k % kTestPatternCount));
+    }
+    std::vector<GrayscaleImage> expected(images);
+    for (GrayscaleImage& image : expected) {
+        Filter::apply_gaussian_smoothing(image, 25, 4.0);
+    }
+
+    TaskScheduler::instance().parallel_for(0, static_cast<int>(images.size()), [&](int begin, int end) {
+        for (int k = begin; k < end; ++k) {
+            Filter::apply_gaussian_smoothing(images[k], 25, 4.0);
+        }
+    }, 1);
+
+    bool same = true;
+    for (std::size_t k = 0; k < images.size(); ++k) {
+        same = same && images[k] == expected[k];
+    }
+    CHECK(same);
+}
+
+// After the first frame, further frames of the same size reuse every pixel buffer: what is still
+// allocated (the std::function each parallel_for call wraps its body in) stays below one image row.
+// Checked with a single scheduler thread, workers add the scheduler's own per-task state.
+static void test_frames_reuse_buffers() {
+    GrayscaleImage frame = make_test_image(640, 480, 1);
+    Filter::apply_gaussian_smoothing(frame, 2 * 18 + 1, 6.0);
+
+    const int frames = 3;
+    std::size_t before = allocatedBytes.load();
+    for (int k = 0; k < frames; ++k) {
+        Filter::apply_gaussian_smoothing(frame, 2 * 18 + 1, 6.0);
+    }
+    CHECK((allocatedBytes.load() - before) / frames < frame.get_width() * sizeof(int));
+}
+
+int main() {
+    for (int threads : {1, 4}) {
+        TaskScheduler::configure(threads);
+        test_matches_direct_path();
+        test_routing();
+        test_concurrent_calls();
+    }
+
+    TaskScheduler::configure(1);
+    test_frames_reuse_buffers();
+    return test_failures() == 0 ? 0 : 1;
+}
@@ -0,0 +1,98 @@
+#include "GrayscaleImage.h"
+#include "test_util.h"
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+
+// Widths around the 8-pixel vector size exercise both the vector body and the scalar tail
+static void fill_random(GrayscaleImage& image, unsigned seed) {
+    std::srand(seed);
+    for (int i = 0; i < image.get_height(); ++i) {
+        for (int j = 0; j < image.get_width(); ++j) {
+            image.set_pixel(i, j, std::rand() % 256);
+        }
+    }
+}
+
+static void test_operators(int width, int height) {
+    GrayscaleImage a(width, height);
+    GrayscaleImage b(width, height);
+    fill_random(a, 1u + width);
+    fill_random(b, 2u + height);
+
+    GrayscaleImage sum = a + b;
+    GrayscaleImage difference = a - b;
+    GrayscaleImage addInPlace(a);
+    addInPlace += b;
+    GrayscaleImage subInPlace(a);
+    subInPlace -= b;
+    GrayscaleImage absolute(a);
+    absolute.abs_diff(b);
+    GrayscaleImage blended(a);
+    blended.blend(b, 0.25);
+
+    bool correct = true;
+    for (int i = 0; i < height; ++i) {
+        for (int j = 0; j < width; ++j) {
+            int p = a.get_pixel(i, j);
+            int q = b.get_pixel(i, j);
+            correct = correct && sum.get_pixel(i, j) == std::min(p + q, 255);
+            correct = correct && addInPlace.get_pixel(i, j) == std::min(p + q, 255);
+            correct = correct && difference.get_pixel(i, j) == std::max(p - q, 0);
+            correct = correct && subInPlace.get_pixel(i, j) == std::max(p - q, 0);
+            correct = correct && absolute.get_pixel(i, j) == std::abs(p - q);
+            correct = correct && blended.get_pixel(i, j) == (p * 192 + q * 64 + 128) >> 8;
+        }
+    }
+    CHECK(correct);
+}
+
+static void test_equality() {
+    GrayscaleImage a(21, 9);
+    fill_random(a, 7);
+    GrayscaleImage b(a);
+    CHECK(a == b);
+
+    b.set_pixel(8, 20, (b.get_pixel(8, 20) + 1) % 256);
+    CHECK(!(a == b));
+
+    GrayscaleImage other(9, 21);
+    CHECK(!(a == other));
+}
+
+static void test_blend_limits() {
+    GrayscaleImage a(16, 4);
+    GrayscaleImage b(16, 4);
+    fill_random(a, 3);
+    fill_random(b, 4);
+
+    GrayscaleImage keep(a);
+    keep.blend(b, 0.0);
+    CHECK(keep == a);
+
+    GrayscaleImage replace(a);
+    replace.blend(b, 1.0);
+    CHECK(replace == b);
+}
+
+static void test_size_mismatch_throws() {
+    GrayscaleImage a(10, 10);
+    GrayscaleImage b(10, 11);
+    bool threw = false;
+    try {
+        a += b;
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+int main() {
+    for (int width : {1, 7, 8, 9, 31, 64, 257}) {
+        test_operators(width, 5);
+    }
+    test_equality();
+    test_blend_limits();
+    test_size_mismatch_throws();
+    return test_failures() == 0 ? 0 : 1;
+}
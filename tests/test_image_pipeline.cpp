@@ -0,0 +1,134 @@
+#include "Filter.h"
+#include "ImagePipeline.h"
+#include "TaskScheduler.h"
+#include "test_util.h"
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+namespace fs = std::filesystem;
+
+// Deterministic test image, different for every seed
+static GrayscaleImage make_image(int seed) {
+    GrayscaleImage image(37, 23);
+    for (int i = 0; i < image.get_height(); ++i) {
+        for (int j = 0; j < image.get_width(); ++j) {
+            image.set_pixel(i, j, (i * 7 + j * seed) % 256);
+        }
+    }
+    return image;
+}
+
+static void apply_chain(GrayscaleImage& image) {
+    Filter::apply_mean_filter(image, 3);
+    Filter::apply_median_filter(image, 3);
+}
+
+static void test_directory_run(const fs::path& root) {
+    fs::path input = root / "in";
+    fs::path output = root / "out";
+    fs::remove_all(root);
+    fs::create_directories(input);
+
+    const int imageCount = 30;
+    for (int k = 0; k < imageCount; ++k) {
+        make_image(k).save_to_file((input / ("image" + std::to_string(k) + ".png")).string().c_str());
+    }
+
+    // Same stem, different extension: both must be written, to different files
+    make_image(100).save_to_file((input / "twin.png").string().c_str());
+    make_image(101).save_to_file((input / "twin.jpg").string().c_str());
+
+    // Not an image: reported as a failure, the rest still goes through
+    std::ofstream(input / "broken.png") << "not an image";
+
+    ImagePipeline::Config config;
+    config.queue_capacity = 2;
+    config.cpu_tasks = 3;
+    ImagePipeline pipeline(config);
+    pipeline.add_filter(apply_chain);
+
+    ImagePipeline::Stats stats = pipeline.run(input.string(), output.string());
+    CHECK(stats.written == imageCount + 2);
+    CHECK(stats.failed == 1);
+
+    int filesOnDisk = 0;
+    for (const fs::directory_entry& entry : fs::directory_iterator(output)) {
+        filesOnDisk += entry.is_regular_file() ? 1 : 0;
+    }
+    CHECK(filesOnDisk == stats.written);
+
+    for (int k = 0; k < imageCount; k += 7) {
+        GrayscaleImage expected = make_image(k);
+        apply_chain(expected);
+        GrayscaleImage written((output / ("image" + std::to_string(k) + ".png")).string().c_str());
+        CHECK(written == expected);
+    }
+
+    GrayscaleImage twinPng = make_image(100);
+    GrayscaleImage twinJpg = make_image(101);
+    apply_chain(twinPng);
+    apply_chain(twinJpg);
+    CHECK(GrayscaleImage((output / "twin.png.png").string().c_str()) == twinPng);
+    CHECK(GrayscaleImage((output / "twin.jpg.png").string().c_str()) == twinJpg);
+}
+
+// Inputs that cannot be given distinct output names are rejected before anything runs
+static void test_unresolvable_collision(const fs::path& root) {
+    fs::path input = root / "in";
+    fs::remove_all(root);
+    fs::create_directories(input);
+
+    std::vector<std::string> files = {(input / "a.jpg").string(), (input / "a.png").string(),
+                                      (input / "a.jpg.png").string()};
+
+    bool threw = false;
+    try {
+        ImagePipeline().run(files, (root / "out").string());
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    CHECK(threw);
+    CHECK(!fs::exists(root / "out"));
+}
+
+// A filter step that throws something other than std::exception fails its images, run() still returns
+static void test_throwing_filter(const fs::path& root) {
+    fs::path input = root / "in";
+    fs::remove_all(root);
+    fs::create_directories(input);
+
+    const int imageCount = 12;
+    for (int k = 0; k < imageCount; ++k) {
+        make_image(k).save_to_file((input / ("image" + std::to_string(k) + ".png")).string().c_str());
+    }
+
+    ImagePipeline::Config config;
+    config.queue_capacity = 2;
+    config.cpu_tasks = 2;
+    ImagePipeline pipeline(config);
+    pipeline.add_filter([](GrayscaleImage& image) {
+        if (image.get_pixel(0, 1) % 2 == 0) {
+            throw 42;
+        }
+    });
+
+    ImagePipeline::Stats stats = pipeline.run(input.string(), (root / "out").string());
+    CHECK(stats.written == imageCount / 2);
+    CHECK(stats.failed == imageCount / 2);
+}
+
+int main() {
+    fs::path root = fs::temp_directory_path() / "test_image_pipeline";
+
+    for (int threads : {1, 4}) {
+        TaskScheduler::configure(threads);
+        test_directory_run(root);
+        test_unresolvable_collision(root);
+        test_throwing_filter(root);
+    }
+
+    fs::remove_all(root);
+    return test_failures() == 0 ? 0 : 1;
+}
@@ -0,0 +1,89 @@
+#include "Filter.h"
+#include "TaskScheduler.h"
+#include "test_util.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+// Reference filters: sort or scan the pixels of the window that lie inside the image
+enum class Operation { Median, Min, Max };
+
+static GrayscaleImage brute_force(const GrayscaleImage& image, int kernelSize, Operation operation) {
+    int width = image.get_width();
+    int height = image.get_height();
+    int halfKernel = kernelSize / 2;
+    GrayscaleImage result(width, height);
+
+    std::vector<int> window;
+    for (int i = 0; i < height; ++i) {
+        for (int j = 0; j < width; ++j) {
+            window.clear();
+            for (int ni = std::max(0, i - halfKernel); ni <= std::min(height - 1, i + halfKernel); ++ni) {
+                for (int nj = std::max(0, j - halfKernel); nj <= std::min(width - 1, j + halfKernel); ++nj) {
+                    window.push_back(image.get_pixel(ni, nj));
+                }
+            }
+
+            int value;
+            if (operation == Operation::Median) {
+                std::nth_element(window.begin(), window.begin() + window.size() / 2, window.end());
+                value = window[window.size() / 2];
+            } else if (operation == Operation::Min) {
+                value = *std::min_element(window.begin(), window.end());
+            } else {
+                value = *std::max_element(window.begin(), window.end());
+            }
+            result.set_pixel(i, j, value);
+        }
+    }
+    return result;
+}
+
+// Noise, or few distinct values so the median often lands on runs of equal pixels
+static GrayscaleImage make_image(int width, int height, int levels) {
+    GrayscaleImage image(width, height);
+    std::srand(37);
+    for (int i = 0; i < height; ++i) {
+        for (int j = 0; j < width; ++j) {
+            image.set_pixel(i, j, (std::rand() % levels) * (255 / (levels - 1)));
+        }
+    }
+    return image;
+}
+
+// Kernels from a single pixel up to wider than the image, odd and even
+static void test_against_brute_force() {
+    const int sizes[][2] = {{61, 47}, {9, 130}, {130, 9}};
+    for (const auto& size : sizes) {
+        for (int levels : {256, 3}) {
+            GrayscaleImage image = make_image(size[0], size[1], levels);
+            for (int kernelSize : {1, 3, 4, 5, 9, 15, 31, 51, 201}) {
+                GrayscaleImage median(image);
+                GrayscaleImage minimum(image);
+                GrayscaleImage maximum(image);
+                Filter::apply_median_filter(median, kernelSize);
+                Filter::apply_min_filter(minimum, kernelSize);
+                Filter::apply_max_filter(maximum, kernelSize);
+
+                bool medianOk = median == brute_force(image, kernelSize, Operation::Median);
+                bool minOk = minimum == brute_force(image, kernelSize, Operation::Min);
+                bool maxOk = maximum == brute_force(image, kernelSize, Operation::Max);
+                if (!medianOk || !minOk || !maxOk) {
+                    std::cerr << size[0] << "x" << size[1] << " levels " << levels << " K=" << kernelSize << std::endl;
+                }
+                CHECK(medianOk);
+                CHECK(minOk);
+                CHECK(maxOk);
+            }
+        }
+    }
+}
+
+int main() {
+    for (int threads : {1, 4}) {
+        TaskScheduler::configure(threads);
+        test_against_brute_force();
+    }
+    return test_failures() == 0 ? 0 : 1;
+}
@@ -0,0 +1,108 @@
+#include "TaskScheduler.h"
+#include "test_util.h"
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+// Every index of the range is visited exactly once
+static void test_parallel_for_covers_range() {
+    std::vector<std::atomic<int>> visits(10007);
+    TaskScheduler::instance().parallel_for(0, static_cast<int>(visits.size()), [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            visits[i]++;
+        }
+    }, 13);
+
+    bool once = true;
+    for (std::atomic<int>& count : visits) {
+        once = once && count.load() == 1;
+    }
+    CHECK(once);
+}
+
+// parallel_for inside a parallel_for task does not deadlock
+static void test_nested_parallel_for() {
+    std::atomic<long> total(0);
+    TaskScheduler::instance().parallel_for(0, 64, [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            TaskScheduler::instance().parallel_for(0, 1000, [&](int b, int e) { total += e - b; }, 7);
+        }
+    }, 1);
+    CHECK(total.load() == 64000);
+}
+
+// The first exception thrown by a task reaches the waiting thread
+static void test_exception_propagates() {
+    bool caught = false;
+    try {
+        TaskScheduler::instance().parallel_for(0, 100, [](int begin, int end) {
+            if (begin <= 60 && 60 < end) {
+                throw std::runtime_error("task failed");
+            }
+        }, 5);
+    } catch (const std::runtime_error&) {
+        caught = true;
+    }
+    CHECK(caught);
+}
+
+// TaskGroup waits for all of its tasks
+static void test_task_group() {
+    std::atomic<int> done(0);
+    TaskGroup group;
+    for (int i = 0; i < 500; ++i) {
+        group.run([&done]() { done++; });
+    }
+    group.wait();
+    CHECK(done.load() == 500);
+}
+
+// configure resizes the shared scheduler without invalidating references to it
+static void test_configure_keeps_instance() {
+    TaskScheduler* before = &TaskScheduler::instance();
+    TaskScheduler::configure(3);
+    CHECK(&TaskScheduler::instance() == before);
+    CHECK(TaskScheduler::instance().get_thread_count() == 3);
+    TaskScheduler::configure(0);
+    CHECK(TaskScheduler::instance().get_thread_count() >= 1);
+}
+
+// configure refuses to resize while a task is queued or running
+static void test_configure_while_busy_throws() {
+    std::atomic<bool> release(false);
+    TaskGroup group;
+    group.run([&release]() {
+        while (!release.load()) {
+            std::this_thread::yield();
+        }
+    });
+
+    bool threw = false;
+    try {
+        TaskScheduler::configure(2);
+    } catch (const std::logic_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+
+    release = true;
+    group.wait();
+}
+
+int main() {
+    for (int threads : {1, 4}) {
+        TaskScheduler::configure(threads);
+        test_parallel_for_covers_range();
+        test_nested_parallel_for();
+        test_exception_propagates();
+        test_task_group();
+        test_configure_while_busy_throws();
+    }
+    test_configure_keeps_instance();
+
+    // Pinning may legitimately fail in a restricted environment, but must not break the scheduler
+    TaskScheduler::configure(2, true);
+    test_parallel_for_covers_range();
+
+    return test_failures() == 0 ? 0 : 1;
+}
@@ -0,0 +1,57 @@
+#ifndef TEST_UTIL_H
+#define TEST_UTIL_H
+
+#include "GrayscaleImage.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+// Minimal check macro for the standalone test executables: reports the failing expression
+// and counts failures, main() returns test_failures() so ctest sees a non-zero exit code.
+inline int& test_failures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(condition)                                                                    \
+    do {                                                                                    \
+        if (!(condition)) {                                                                 \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK failed: " #condition << std::endl; \
+            test_failures()++;                                                              \
+        }                                                                                   \
+    } while (0)
+
+// Input patterns of the filter accuracy tests, see make_test_image
+const int kTestPatternCount = 3;
+
+// Pattern 0 is flat white (the zero border darkens the edges most), 1 is noise from a fixed seed,
+// 2 is a checkerboard of cellSize x cellSize squares (the largest pixel-to-neighbour differences)
+inline GrayscaleImage make_test_image(int width, int height, int pattern, int cellSize = 8) {
+    GrayscaleImage image(width, height);
+    std::srand(11);
+    for (int i = 0; i < height; ++i) {
+        for (int j = 0; j < width; ++j) {
+            int value = 255;
+            if (pattern == 1) {
+                value = std::rand() % 256;
+            } else if (pattern == 2) {
+                value = ((i / cellSize + j / cellSize) % 2) * 255;
+            }
+            image.set_pixel(i, j, value);
+        }
+    }
+    return image;
+}
+
+// Largest per-pixel difference between two images of the same size
+inline int max_difference(const GrayscaleImage& a, const GrayscaleImage& b) {
+    int largest = 0;
+    for (int i = 0; i < a.get_height(); ++i) {
+        for (int j = 0; j < a.get_width(); ++j) {
+            largest = std::max(largest, std::abs(a.get_pixel(i, j) - b.get_pixel(i, j)));
+        }
+    }
+    return largest;
+}
+
+#endif // TEST_UTIL_H
@@ -0,0 +1,142 @@
+#include "Filter.h"
+#include "ImagePipeline.h"
+#include "TaskScheduler.h"
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Runs a filter chain over every image of a directory.
+//
+//   pipeline_main [options] <input_dir> <output_dir> <filter> [<filter> ...]
+//
+// Options:    --read N --write N (I/O threads), --cpu N (images in flight on the scheduler),
+//             --queue N (images read ahead), --threads N (scheduler threads, 0 = one per CPU)
+// Filters:    mean[:k]  gaussian[:k[:sigma]]  gaussian_fixed[:k[:sigma]]  unsharp[:k[:amount]]
+//             unsharp_fixed[:k[:amount]]  median[:k]  min[:k]  max[:k]
+
+static void print_usage() {
+    std::cerr << "Usage: pipeline_main [--read N] [--write N] [--cpu N] [--queue N] [--threads N]\n"
+                 "                     <input_dir> <output_dir> <filter>[:k[:param]] ...\n"
+                 "Filters: mean, gaussian, gaussian_fixed, unsharp, unsharp_fixed, median, min, max"
+              << std::endl;
+}
+
+// Split "name:a:b" at the colons
+static std::vector<std::string> split_spec(const std::string& spec) {
+    std::vector<std::string> parts;
+    std::stringstream stream(spec);
+    std::string part;
+    while (std::getline(stream, part, ':')) {
+        parts.push_back(part);
+    }
+    return parts;
+}
+
+// Turn a filter specification into a pipeline step, throws on unknown names and invalid parameters
+static ImagePipeline::FilterStep parse_filter(const std::string& spec) {
+    std::vector<std::string> parts = split_spec(spec);
+    if (parts.empty()) {
+        throw std::invalid_argument("empty filter specification");
+    }
+
+    const std::string& name = parts[0];
+    int k = parts.size() > 1 ? std::stoi(parts[1]) : 3;
+    double param = parts.size() > 2 ? std::stod(parts[2]) : 0.0;
+    bool hasParam = parts.size() > 2;
+
+    // The filters assume a kernel of at least one pixel and a positive sigma
+    if (k < 1) {
+        throw std::invalid_argument("kernel size of '" + spec + "' must be at least 1");
+    }
+    if ((name == "gaussian" || name == "gaussian_fixed") && hasParam && !(param > 0.0)) {
+        throw std::invalid_argument("sigma of '" + spec + "' must be positive");
+    }
+
+    if (name == "mean") {
+        return [k](GrayscaleImage& image) { Filter::apply_mean_filter(image, k); };
+    }
+    if (name == "gaussian") {
+        double sigma = hasParam ? param : 1.0;
+        return [k, sigma](GrayscaleImage& image) { Filter::apply_gaussian_smoothing(image, k, sigma); };
+    }
+    if (name == "gaussian_fixed") {
+        double sigma = hasParam ? param : 1.0;
+        return [k, sigma](GrayscaleImage& image) { Filter::apply_gaussian_smoothing_fixed(image, k, sigma); };
+    }
+    if (name == "unsharp") {
+        double amount = hasParam ? param : 1.5;
+        return [k, amount](GrayscaleImage& image) { Filter::apply_unsharp_mask(image, k, amount); };
+    }
+    if (name == "unsharp_fixed") {
+        double amount = hasParam ? param : 1.5;
+        return [k, amount](GrayscaleImage& image) { Filter::apply_unsharp_mask_fixed(image, k, amount); };
+    }
+    if (name == "median") {
+        return [k](GrayscaleImage& image) { Filter::apply_median_filter(image, k); };
+    }
+    if (name == "min") {
+        return [k](GrayscaleImage& image) { Filter::apply_min_filter(image, k); };
+    }
+    if (name == "max") {
+        return [k](GrayscaleImage& image) { Filter::apply_max_filter(image, k); };
+    }
+    throw std::invalid_argument("unknown filter '" + name + "'");
+}
+
+int main(int argc, char** argv) {
+    ImagePipeline::Config config;
+    int schedulerThreads = -1;
+    std::vector<std::string> positional;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg.rfind("--", 0) == 0) {
+                if (i + 1 >= argc) {
+                    throw std::invalid_argument("missing value for " + arg);
+                }
+                int value = std::stoi(argv[++i]);
+                if (arg == "--read") {
+                    config.read_threads = value;
+                } else if (arg == "--write") {
+                    config.write_threads = value;
+                } else if (arg == "--cpu") {
+                    config.cpu_tasks = value;
+                } else if (arg == "--queue") {
+                    config.queue_capacity = static_cast<std::size_t>(value);
+                } else if (arg == "--threads") {
+                    schedulerThreads = value;
+                } else {
+                    throw std::invalid_argument("unknown option " + arg);
+                }
+            } else {
+                positional.push_back(arg);
+            }
+        }
+
+        if (positional.size() < 3) {
+            print_usage();
+            return 2;
+        }
+
+        if (schedulerThreads >= 0) {
+            TaskScheduler::configure(schedulerThreads);
+        }
+
+        ImagePipeline pipeline(config);
+        for (std::size_t i = 2; i < positional.size(); ++i) {
+            pipeline.add_filter(parse_filter(positional[i]));
+        }
+
+        ImagePipeline::Stats stats = pipeline.run(positional[0], positional[1]);
+        std::cout << stats.written << " written, " << stats.failed << " failed" << std::endl;
+        return stats.failed == 0 ? 0 : 1;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        print_usage();
+        return 2;
+    }
+}